@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utl/verify.h"
+
+#include "motis/core/common/dial.h"
+#include "motis/core/common/flat_matrix.h"
+
+namespace motis {
+
+// all pairs shortest paths for sparse matrices with small integer distances:
+// runs one dijkstra (with a bucket queue) per source row
+// - results match floyd_warshall (distances saturate at the max value, which
+//   marks unreachable pairs), except for the diagonal which is not modified
+// - faster than floyd_warshall if the number of edges is much smaller than
+//   the number of matrix entries
+template <typename T>
+void all_pairs_dial(T&& mat) {
+  utl::verify(mat.entries_.size() == mat.column_count_ * mat.column_count_,
+              "all_pairs_dial: input is not a square matrix.");
+  using value_type = typename std::decay_t<T>::value_type;
+  static_assert(std::is_unsigned_v<value_type> && sizeof(value_type) <= 2,
+                "all_pairs_dial: bucket queue requires small distances");
+  constexpr auto const kMaxDistance = std::numeric_limits<value_type>::max();
+
+  struct label {
+    std::uint32_t node_;
+    value_type dist_;
+  };
+  struct get_bucket {
+    std::size_t operator()(label const& l) const { return l.dist_; }
+  };
+
+  auto const n = mat.column_count_;
+  auto adjacency =
+      std::vector<std::vector<std::pair<std::uint32_t, value_type>>>(n);
+  for (auto i = 0U; i < n; ++i) {
+    for (auto j = 0U; j < n; ++j) {
+      if (i != j && mat(i, j) != kMaxDistance) {
+        adjacency[i].emplace_back(j, mat(i, j));
+      }
+    }
+  }
+
+  dial<label, kMaxDistance, get_bucket> pq;
+  auto dists = std::vector<value_type>(n);
+  for (auto source = 0U; source < n; ++source) {
+    std::fill(begin(dists), end(dists), kMaxDistance);
+    dists[source] = 0;
+    pq.push(label{source, 0});
+    while (!pq.empty()) {
+      auto const l = pq.top();
+      pq.pop();
+      if (l.dist_ > dists[l.node_]) {
+        continue;
+      }
+      for (auto const& [to, weight] : adjacency[l.node_]) {
+        auto const new_dist = static_cast<unsigned>(l.dist_) + weight;
+        if (new_dist < kMaxDistance && new_dist < dists[to]) {
+          dists[to] = static_cast<value_type>(new_dist);
+          pq.push(label{to, static_cast<value_type>(new_dist)});
+        }
+      }
+    }
+    for (auto j = 0U; j < n; ++j) {
+      if (j != source) {
+        mat(source, j) = dists[j];
+      }
+    }
+  }
+}
+
+}  // namespace motis
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
 #include "utl/verify.h"
 
 #include "motis/core/common/flat_matrix.h"
@@ -28,4 +32,68 @@ void floyd_warshall(T&& mat) {
   }
 }
 
+// cache-blocked floyd warshall (same results as floyd_warshall):
+// processes the matrix in block_size x block_size tiles so that the three
+// tiles used by the min-plus kernel stay in cache, the branch-free inner loop
+// over a contiguous row is auto-vectorized for small value types (uint8_t)
+template <typename T>
+void floyd_warshall_blocked(T&& mat, std::uint32_t const block_size = 64U) {
+  utl::verify(mat.entries_.size() == mat.column_count_ * mat.column_count_,
+              "floyd_warshall_blocked: input is not a square matrix.");
+  utl::verify(block_size != 0U, "floyd_warshall_blocked: invalid block size");
+  using value_type = typename std::decay_t<T>::value_type;
+  constexpr uint64_t const kMaxDistance =
+      std::numeric_limits<value_type>::max();
+
+  auto const n = static_cast<std::size_t>(mat.column_count_);
+  auto* const m = mat.entries_.data();
+
+  auto const kernel = [&](std::size_t const ib, std::size_t const jb,
+                          std::size_t const kb) {
+    auto const i_end = std::min(ib + block_size, n);
+    auto const j_end = std::min(jb + block_size, n);
+    auto const k_end = std::min(kb + block_size, n);
+    for (auto k = kb; k < k_end; ++k) {
+      value_type const* const row_k = m + k * n;
+      for (auto i = ib; i < i_end; ++i) {
+        auto const d_ik = static_cast<uint64_t>(m[i * n + k]);
+        if (d_ik == kMaxDistance) {
+          continue;
+        }
+        value_type* const row_i = m + i * n;
+        for (auto j = jb; j < j_end; ++j) {
+          auto const distance = static_cast<value_type>(std::min(
+              kMaxDistance, d_ik + static_cast<uint64_t>(row_k[j])));
+          row_i[j] = std::min(row_i[j], distance);
+        }
+      }
+    }
+  };
+
+  for (auto kb = std::size_t{0U}; kb < n; kb += block_size) {
+    // 1. diagonal block
+    kernel(kb, kb, kb);
+
+    // 2. blocks in row / column kb (only depend on the diagonal block)
+    for (auto b = std::size_t{0U}; b < n; b += block_size) {
+      if (b != kb) {
+        kernel(kb, b, kb);
+        kernel(b, kb, kb);
+      }
+    }
+
+    // 3. remaining blocks (only depend on the row / column blocks)
+    for (auto ib = std::size_t{0U}; ib < n; ib += block_size) {
+      if (ib == kb) {
+        continue;
+      }
+      for (auto jb = std::size_t{0U}; jb < n; jb += block_size) {
+        if (jb != kb) {
+          kernel(ib, jb, kb);
+        }
+      }
+    }
+  }
+}
+
 }  // namespace motis
@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include "motis/core/common/all_pairs_dial.h"
+#include "motis/core/common/floyd_warshall.h"
+#include "motis/core/common/logging.h"
+
+namespace motis {
+
+namespace {
+
+constexpr auto const kInvalid = std::numeric_limits<std::uint8_t>::max();
+
+flat_matrix<std::vector<std::uint8_t>> make_random_matrix(
+    std::uint32_t const size, double const edge_probability,
+    unsigned const seed) {
+  auto mat = make_std_flat_matrix<std::uint8_t>(size, kInvalid);
+  auto rng = std::mt19937{seed};
+  auto edge_dist = std::bernoulli_distribution{edge_probability};
+  auto duration_dist = std::uniform_int_distribution<int>{1, 30};
+  for (auto i = 0U; i < size; ++i) {
+    for (auto j = 0U; j < size; ++j) {
+      if (i != j && edge_dist(rng)) {
+        mat(i, j) = static_cast<std::uint8_t>(duration_dist(rng));
+      }
+    }
+  }
+  return mat;
+}
+
+void expect_equal_off_diagonal(flat_matrix<std::vector<std::uint8_t>>& a,
+                               flat_matrix<std::vector<std::uint8_t>>& b) {
+  ASSERT_EQ(a.column_count_, b.column_count_);
+  for (auto i = 0U; i < a.column_count_; ++i) {
+    for (auto j = 0U; j < a.column_count_; ++j) {
+      if (i != j) {
+        ASSERT_EQ(a(i, j), b(i, j)) << "i=" << i << ", j=" << j;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(core_floyd_warshall, blocked_matches_naive) {
+  for (auto const size : {1U, 7U, 64U, 100U, 200U}) {
+    for (auto const p : {0.02, 0.1, 0.5}) {
+      auto naive = make_random_matrix(size, p, size);
+      auto blocked = naive;
+      auto blocked_small = naive;
+      floyd_warshall(naive);
+      floyd_warshall_blocked(blocked);
+      floyd_warshall_blocked(blocked_small, 16U);
+      EXPECT_EQ(naive.entries_, blocked.entries_);
+      EXPECT_EQ(naive.entries_, blocked_small.entries_);
+    }
+  }
+}
+
+TEST(core_floyd_warshall, dial_matches_naive) {
+  for (auto const size : {2U, 7U, 100U, 200U}) {
+    for (auto const p : {0.01, 0.05, 0.3}) {
+      auto naive = make_random_matrix(size, p, size + 1);
+      auto dial = naive;
+      floyd_warshall(naive);
+      all_pairs_dial(dial);
+      expect_equal_off_diagonal(naive, dial);
+    }
+  }
+}
+
+TEST(core_floyd_warshall, long_paths_saturate) {
+  // chain 0 -> 1 -> ... -> 19 with 20 minutes per edge:
+  // paths >= 255 minutes are unreachable
+  auto const size = 20U;
+  auto mat = make_std_flat_matrix<std::uint8_t>(size, kInvalid);
+  for (auto i = 0U; i + 1 < size; ++i) {
+    mat(i, i + 1) = 20U;
+  }
+  auto naive = mat;
+  auto blocked = mat;
+  auto dial = mat;
+  floyd_warshall(naive);
+  floyd_warshall_blocked(blocked, 4U);
+  all_pairs_dial(dial);
+
+  EXPECT_EQ(240U, naive(0, 12));
+  EXPECT_EQ(kInvalid, naive(0, 13));
+  EXPECT_EQ(naive.entries_, blocked.entries_);
+  expect_equal_off_diagonal(naive, dial);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(core_floyd_warshall, DISABLED_benchmark) {
+  using clock = std::chrono::steady_clock;
+  auto const ms = [](clock::time_point const start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() -
+                                                                 start)
+        .count();
+  };
+
+  for (auto const size : {500U, 1000U, 2000U}) {
+    for (auto const p : {0.005, 0.1}) {
+      auto const input = make_random_matrix(size, p, 42U);
+
+      auto naive = input;
+      auto start = clock::now();
+      floyd_warshall(naive);
+      auto const naive_ms = ms(start);
+
+      auto blocked = input;
+      start = clock::now();
+      floyd_warshall_blocked(blocked);
+      auto const blocked_ms = ms(start);
+
+      auto dial = input;
+      start = clock::now();
+      all_pairs_dial(dial);
+      auto const dial_ms = ms(start);
+
+      LOG(logging::info) << "size=" << size << ", p=" << p << ": naive "
+                         << naive_ms << "ms, blocked " << blocked_ms
+                         << "ms, dial " << dial_ms << "ms";
+      EXPECT_EQ(naive.entries_, blocked.entries_);
+    }
+  }
+}
+
+}  // namespace motis
@@ -8,8 +8,23 @@
 
 namespace motis::launcher {
 
+struct batch_options {
+  // one JSON message per line or (*.bin) length-prefixed flatbuffers:
+  // [uint32 size (little endian)][message]...
+  std::string input_file_path_;
+  std::string output_file_path_;
+  // optional: id,target,latency_us,service_time_us,error
+  std::string latency_file_path_;
+  unsigned concurrency_{1U};
+  // 0 = no limit, otherwise latencies are measured from the scheduled send
+  // time of each query (not from the actual send time) so delays caused by
+  // the server falling behind are not omitted
+  double target_qps_{0.0};
+};
+
+// all queries are parsed before the replay starts, a summary (throughput,
+// latency percentiles per target) is logged when all responses arrived
 void inject_queries(boost::asio::io_service&, motis::module::receiver&,
-                    std::string const& input_file_path,
-                    std::string const& output_file_path, int num_threads);
+                    batch_options const&);
 
 }  // namespace motis::launcher
@@ -48,6 +48,11 @@ public:
           "test = exit after 1s");
     param(batch_input_file_, "batch_input_file", "query file");
     param(batch_output_file_, "batch_output_file", "response file");
+    param(batch_latency_file_, "batch_latency_file",
+          "per query latency csv file (optional)");
+    param(batch_concurrency_, "batch_concurrency",
+          "max. queries in flight (0 = 2 * num_threads)");
+    param(batch_qps_, "batch_qps", "target queries per second (0 = no limit)");
     param(init_, "init", "init operation");
     param(num_threads_, "num_threads", "number of worker threads");
     param(direct_mode_, "direct", "no ctx/multi-threading");
@@ -56,6 +61,9 @@ public:
   motis_mode_t mode_{launcher_settings::motis_mode_t::SERVER};
   std::string batch_input_file_{"queries.txt"};
   std::string batch_output_file_{"responses.txt"};
+  std::string batch_latency_file_;
+  unsigned batch_concurrency_{0U};
+  double batch_qps_{0.0};
   std::string init_;
   unsigned num_threads_{std::thread::hardware_concurrency()};
   bool direct_mode_{sizeof(void*) >= 8 ? false : true};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace motis::launcher {
+
+enum class content_coding { IDENTITY, GZIP, DEFLATE };
+
+// responses smaller than this are not compressed
+constexpr auto const kMinCompressedResponseSize = std::size_t{1024U};
+
+// picks the coding with the highest q-value from an Accept-Encoding header
+// (ties: gzip > deflate > identity, codings with q=0 are never selected,
+// "*" applies to all codings not listed explicitly)
+content_coding select_content_coding(std::string_view accept_encoding);
+
+char const* to_str(content_coding);
+
+// compresses the input block by block (the output grows incrementally)
+std::string compress(std::string_view input, content_coding);
+
+}  // namespace motis::launcher
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -28,6 +29,10 @@ struct web_server {
               boost::system::error_code& ec);
   void stop();
 
+  // GET /metrics responds with the output of the given function
+  // (Prometheus text format)
+  void set_metrics_provider(std::function<std::string()>);
+
 private:
   struct impl;
   std::unique_ptr<impl> impl_;
@@ -1,13 +1,23 @@
 #include "motis/launcher/batch_mode.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <istream>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <system_error>
+#include <vector>
 
-#include "utl/erase.h"
+#include "boost/asio/steady_timer.hpp"
+
+#include "utl/verify.h"
 
 #include "motis/core/common/logging.h"
 #include "motis/module/message.h"
@@ -16,32 +26,109 @@ using namespace motis::module;
 
 namespace motis::launcher {
 
+namespace {
+
+std::vector<msg_ptr> read_json_queries(std::ifstream& in) {
+  std::vector<msg_ptr> queries;
+  std::string json;
+  auto line = 0U;
+  while (std::getline(in, json)) {
+    ++line;
+    if (json.empty()) {
+      continue;
+    }
+    try {
+      queries.emplace_back(make_msg(json));
+    } catch (std::system_error const& e) {
+      LOG(logging::error) << "batch: skipping invalid query in line " << line
+                          << ": " << e.what();
+    }
+  }
+  return queries;
+}
+
+std::vector<msg_ptr> read_binary_queries(std::ifstream& in) {
+  auto const buf = std::string{std::istreambuf_iterator<char>{in},
+                               std::istreambuf_iterator<char>{}};
+  std::vector<msg_ptr> queries;
+  auto offset = std::size_t{0U};
+  while (offset != buf.size()) {
+    utl::verify(offset + 4U <= buf.size(), "batch: truncated size at {}",
+                offset);
+    auto size = std::uint32_t{0U};
+    for (auto i = 0U; i != 4U; ++i) {
+      size |= static_cast<std::uint32_t>(
+                  static_cast<unsigned char>(buf[offset + i]))
+              << (8U * i);
+    }
+    offset += 4U;
+    utl::verify(offset + size <= buf.size(), "batch: truncated message at {}",
+                offset);
+    queries.emplace_back(make_msg(buf.data() + offset, size));
+    offset += size;
+  }
+  return queries;
+}
+
+std::vector<msg_ptr> read_queries(std::string const& path) {
+  std::ifstream in{path, std::ios_base::binary};
+  utl::verify(in.is_open(), "batch: unable to open file {}", path);
+  return path.ends_with(".bin") ? read_binary_queries(in)
+                                : read_json_queries(in);
+}
+
+// nearest-rank percentile of a sorted vector
+double percentile_ms(std::vector<std::chrono::microseconds> const& sorted,
+                     double const p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto const rank = static_cast<std::size_t>(
+      std::ceil(p * static_cast<double>(sorted.size())));
+  auto const idx = std::min(std::max(rank, std::size_t{1U}), sorted.size());
+  return static_cast<double>(sorted[idx - 1U].count()) / 1000.0;
+}
+
+}  // namespace
+
 struct query_injector : std::enable_shared_from_this<query_injector> {
 public:
+  using clock = std::chrono::steady_clock;
+
   query_injector(boost::asio::io_service& ios,
-                 motis::module::receiver& receiver,
-                 std::string const& input_file_path,
-                 std::string const& output_file_path, int num_threads)
+                 motis::module::receiver& receiver, batch_options const& opt)
       : ios_(ios),
         receiver_(receiver),
-        in_(input_file_path),
-        out_(output_file_path),
-        num_threads_(num_threads) {
+        out_(opt.output_file_path_),
+        timer_(ios),
+        concurrency_(std::max(opt.concurrency_, 1U)),
+        target_qps_(opt.target_qps_) {
     try {
-      in_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      out_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      if (!opt.latency_file_path_.empty()) {
+        latency_out_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        latency_out_.open(opt.latency_file_path_);
+        latency_out_ << "id,target,latency_us,service_time_us,error\n";
+      }
     } catch (std::exception const& e) {
-      LOG(logging::error) << "unable to open file " << input_file_path << ": "
-                          << e.what();
+      LOG(logging::error) << "unable to open output file: " << e.what();
       throw;
     }
 
     try {
-      out_.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      queries_ = read_queries(opt.input_file_path_);
     } catch (std::exception const& e) {
-      LOG(logging::error) << "unable to open file " << output_file_path << ": "
-                          << e.what();
+      LOG(logging::error) << "unable to read queries from "
+                          << opt.input_file_path_ << ": " << e.what();
       throw;
     }
+    results_.resize(queries_.size());
+
+    LOG(logging::info) << "batch: " << queries_.size()
+                       << " queries, concurrency=" << concurrency_
+                       << ", target qps="
+                       << (target_qps_ > 0.0 ? std::to_string(target_qps_)
+                                             : std::string{"unlimited"});
   }
 
   query_injector(query_injector const&) = delete;
@@ -53,56 +140,103 @@ public:
   ~query_injector() { ios_.stop(); }
 
   void start() {
-    auto self = shared_from_this();
-    ios_.post([this, self]() {
-      for (int i = 0; i < 2 * num_threads_; ++i) {
-        if (!inject_msg(self)) {
-          break;
-        }
-      }
+    ios_.post([self = shared_from_this()]() {
+      self->start_ = clock::now();
+      self->inject();
     });
   }
 
 private:
-  msg_ptr next_query() {
-    if (in_.eof() || in_.peek() == EOF) {
-      return nullptr;
+  struct result {
+    // from the intended send time (includes the time the query could not be
+    // sent because the server fell behind the target rate)
+    std::chrono::microseconds latency_{};
+    // from the actual send time
+    std::chrono::microseconds service_time_{};
+    bool error_{false};
+  };
+
+  // intended send time of a query when pacing (actual send time otherwise)
+  clock::time_point scheduled(std::size_t const idx,
+                              clock::time_point const now) const {
+    if (target_qps_ <= 0.0) {
+      return now;
+    }
+    return start_ + std::chrono::duration_cast<clock::duration>(
+                        std::chrono::duration<double>(
+                            static_cast<double>(idx) / target_qps_));
+  }
+
+  void inject() {
+    while (in_flight_ < concurrency_ && next_ < queries_.size()) {
+      auto const now = clock::now();
+      if (auto const due = scheduled(next_, now); now < due) {
+        wait_until(due);
+        return;
+      }
+      send(next_++);
     }
 
-    std::string json;
-    std::getline(in_, json);
-    return make_msg(json);
+    if (in_flight_ == 0U && next_ == queries_.size()) {
+      finish();
+    }
   }
 
-  bool inject_msg(std::shared_ptr<query_injector> const&) {
-    msg_ptr next;
+  void wait_until(clock::time_point const due) {
+    if (timer_armed_) {
+      return;
+    }
+    timer_armed_ = true;
+    timer_.expires_at(due);
+    timer_.async_wait(
+        [self = shared_from_this()](boost::system::error_code const& ec) {
+          self->timer_armed_ = false;
+          if (!ec) {
+            self->inject();
+          }
+        });
+  }
+
+  void send(std::size_t const idx) {
+    ++in_flight_;
+    auto const sent = clock::now();
+    auto const due = scheduled(idx, sent);
     try {
-      next = next_query();
-      if (next) {
-        ++in_flight_;
-        receiver_.on_msg(next,
-                         ios_.wrap([self = shared_from_this(), id = next->id()](
-                                       msg_ptr const& res, std::error_code ec) {
-                           self->on_response(self, id, res, ec);
-                         }));
-      } else {
-        if (in_flight_ == 0) {
-          ios_.stop();
-        }
-        return false;
-      }
+      receiver_.on_msg(
+          queries_[idx],
+          ios_.wrap([self = shared_from_this(), idx, due, sent](
+                        msg_ptr const& res, std::error_code ec) {
+            self->on_response(idx, due, sent, res, ec);
+          }));
     } catch (std::system_error const& e) {
-      on_response(shared_from_this(), next ? next->id() : -1, msg_ptr(),
-                  e.code());
+      on_response(idx, due, sent, msg_ptr(), e.code());
     }
-    return true;
   }
 
-  void on_response(std::shared_ptr<query_injector> const& self, int id,
-                   msg_ptr const& res, std::error_code ec) {
+  void on_response(std::size_t const idx, clock::time_point const due,
+                   clock::time_point const sent, msg_ptr const& res,
+                   std::error_code ec) {
     --in_flight_;
-    write_response(id, res, ec);
-    inject_msg(self);
+
+    auto const now = clock::now();
+    auto& r = results_[idx];
+    r.latency_ =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - due);
+    r.service_time_ =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - sent);
+    r.error_ =
+        ec || (res && res->get()->content_type() == MsgContent_MotisError);
+
+    auto const& query = queries_[idx];
+    write_response(query->id(), res, ec);
+    if (latency_out_.is_open()) {
+      latency_out_ << query->id() << ","
+                   << query->get()->destination()->target()->view() << ","
+                   << r.latency_.count() << "," << r.service_time_.count()
+                   << "," << (r.error_ ? 1 : 0) << "\n";
+    }
+
+    inject();
   }
 
   void write_response(int id, msg_ptr const& res, std::error_code ec) {
@@ -118,28 +252,89 @@ private:
     response->get()->mutate_id(id);
 
     out_ << response->to_json(json_format::SINGLE_LINE) << "\n";
+  }
+
+  void finish() {
+    if (finished_) {
+      return;
+    }
+    finished_ = true;
     out_.flush();
+    if (latency_out_.is_open()) {
+      latency_out_.flush();
+    }
+    print_summary();
+    ios_.stop();
+  }
+
+  void print_summary() const {
+    auto const seconds =
+        std::chrono::duration<double>(clock::now() - start_).count();
+
+    struct target_stats {
+      std::vector<std::chrono::microseconds> latencies_, service_times_;
+      std::size_t errors_{0U};
+    };
+    auto targets = std::map<std::string, target_stats>{};
+    auto errors = std::size_t{0U};
+    for (auto i = std::size_t{0U}; i != queries_.size(); ++i) {
+      auto& t = targets[queries_[i]->get()->destination()->target()->str()];
+      t.latencies_.emplace_back(results_[i].latency_);
+      t.service_times_.emplace_back(results_[i].service_time_);
+      if (results_[i].error_) {
+        ++t.errors_;
+        ++errors;
+      }
+    }
+
+    LOG(logging::info) << "batch: " << queries_.size() << " queries in "
+                       << seconds << "s ("
+                       << static_cast<double>(queries_.size()) /
+                              std::max(seconds, 1e-9)
+                       << " queries/s), " << errors << " errors";
+    for (auto& [target, t] : targets) {
+      std::sort(begin(t.latencies_), end(t.latencies_));
+      std::sort(begin(t.service_times_), end(t.service_times_));
+      LOG(logging::info) << "batch: " << target
+                         << ": n=" << t.latencies_.size()
+                         << ", errors=" << t.errors_
+                         << ", p50=" << percentile_ms(t.latencies_, 0.50)
+                         << "ms, p95=" << percentile_ms(t.latencies_, 0.95)
+                         << "ms, p99=" << percentile_ms(t.latencies_, 0.99)
+                         << "ms, max=" << percentile_ms(t.latencies_, 1.0)
+                         << "ms (service time: p50="
+                         << percentile_ms(t.service_times_, 0.50)
+                         << "ms, p99=" << percentile_ms(t.service_times_, 0.99)
+                         << "ms)";
+    }
   }
 
   boost::asio::io_service& ios_;
   motis::module::receiver& receiver_;
 
   boost::asio::io_service::work work_{ios_};
-  unsigned in_flight_{0};
 
-  std::ifstream in_;
+  std::vector<msg_ptr> queries_;
+  std::vector<result> results_;
+  std::size_t next_{0U};
+  unsigned in_flight_{0U};
+
   std::ofstream out_;
+  std::ofstream latency_out_;
+
+  boost::asio::steady_timer timer_;
+  bool timer_armed_{false};
+  bool finished_{false};
+  clock::time_point start_;
 
-  int num_threads_;
+  unsigned concurrency_;
+  double target_qps_;
 };
 
 void inject_queries(boost::asio::io_service& ios,
                     motis::module::receiver& receiver,
-                    std::string const& input_file_path,
-                    std::string const& output_file_path, int num_threads) {
-  std::make_shared<query_injector>(ios, receiver, input_file_path,
-                                   output_file_path, num_threads)
-      ->start();
+                    batch_options const& opt) {
+  std::make_shared<query_injector>(ios, receiver, opt)->start();
 }
 
 }  // namespace motis::launcher
@@ -115,6 +115,9 @@ int main(int argc, char const** argv) {
   try {
     instance.import(module_opt, dataset_opt, import_opt);
     instance.init_modules(module_opt, launcher_opt.num_threads_);
+    instance.scheduler_.configure(launcher_opt.num_threads_);
+    server.set_metrics_provider(
+        [&]() { return instance.prometheus_metrics(); });
     instance.init_remotes(remote_opt.get_remotes());
 
     if (!launcher_opt.init_.empty()) {
@@ -165,11 +168,22 @@ int main(int argc, char const** argv) {
         [&](boost::system::error_code) { instance.runner_.ios().stop(); });
   } else if (launcher_opt.mode_ == launcher_settings::motis_mode_t::BATCH) {
     instance.queue_no_target_msgs_ = true;
+    // replayed queries have to be computed, not served from the cache
+    instance.cache_.set_enabled(false);
+    // concurrency is limited by batch_concurrency, queries must not be
+    // throttled or rejected by the admission control of the server
+    instance.scheduler_.set_enabled(false);
     auto start_batch = [&]() {
       LOG(info) << "starting to inject queries";
       inject_queries(
-          instance.runner_.ios(), instance, launcher_opt.batch_input_file_,
-          launcher_opt.batch_output_file_, launcher_opt.num_threads_);
+          instance.runner_.ios(), instance,
+          batch_options{launcher_opt.batch_input_file_,
+                        launcher_opt.batch_output_file_,
+                        launcher_opt.batch_latency_file_,
+                        launcher_opt.batch_concurrency_ != 0U
+                            ? launcher_opt.batch_concurrency_
+                            : 2U * launcher_opt.num_threads_,
+                        launcher_opt.batch_qps_});
     };
     remote_opt.get_remotes().empty()
         ? start_batch()
@@ -0,0 +1,169 @@
+#include "motis/launcher/response_encoding.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "miniz.h"
+
+#include "utl/verify.h"
+
+namespace motis::launcher {
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) {
+    s.remove_prefix(1);
+  }
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+bool iequals(std::string_view const a, std::string_view const b) {
+  return a.size() == b.size() &&
+         std::equal(begin(a), end(a), begin(b), [](char const x, char const y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+double quality(std::string_view params) {
+  while (!params.empty()) {
+    auto const semicolon = params.find(';');
+    auto const param = trim(params.substr(0, semicolon));
+    if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') &&
+        param[1] == '=') {
+      return std::strtod(std::string{param.substr(2)}.c_str(), nullptr);
+    }
+    params = semicolon == std::string_view::npos ? std::string_view{}
+                                                 : params.substr(semicolon + 1);
+  }
+  return 1.0;
+}
+
+void append_le32(std::string& out, std::uint32_t const v) {
+  for (auto i = 0U; i != 4U; ++i) {
+    out.push_back(static_cast<char>((v >> (8U * i)) & 0xFFU));
+  }
+}
+
+}  // namespace
+
+content_coding select_content_coding(std::string_view accept_encoding) {
+  // q-values, negative: not listed
+  auto gzip = -1.0;
+  auto deflate = -1.0;
+  auto identity = -1.0;
+  auto any = -1.0;
+  while (!accept_encoding.empty()) {
+    auto const comma = accept_encoding.find(',');
+    auto const token = accept_encoding.substr(0, comma);
+    accept_encoding = comma == std::string_view::npos
+                          ? std::string_view{}
+                          : accept_encoding.substr(comma + 1);
+
+    auto const semicolon = token.find(';');
+    auto const coding = trim(token.substr(0, semicolon));
+    auto const q = semicolon == std::string_view::npos
+                       ? 1.0
+                       : quality(token.substr(semicolon + 1));
+    if (iequals(coding, "gzip") || iequals(coding, "x-gzip")) {
+      gzip = q;
+    } else if (iequals(coding, "deflate")) {
+      deflate = q;
+    } else if (iequals(coding, "identity")) {
+      identity = q;
+    } else if (coding == "*") {
+      any = q;
+    }
+  }
+
+  // "*" matches all codings not listed explicitly
+  auto const resolve = [&](double const q) { return q < 0.0 ? any : q; };
+  gzip = resolve(gzip);
+  deflate = resolve(deflate);
+  identity = resolve(identity);
+
+  // on ties, compressed codings are preferred over identity
+  auto const best = std::max(gzip, deflate);
+  if (best <= 0.0 || best < identity) {
+    return content_coding::IDENTITY;
+  }
+  return gzip >= deflate ? content_coding::GZIP : content_coding::DEFLATE;
+}
+
+char const* to_str(content_coding const c) {
+  switch (c) {
+    case content_coding::GZIP: return "gzip";
+    case content_coding::DEFLATE: return "deflate";
+    case content_coding::IDENTITY: return "identity";
+  }
+  return "identity";
+}
+
+std::string compress(std::string_view const input,
+                     content_coding const coding) {
+  if (coding == content_coding::IDENTITY) {
+    return std::string{input};
+  }
+
+  constexpr auto const kInputBlockSize = std::size_t{1024U} * 1024U;
+  constexpr auto const kOutputBlockSize = std::size_t{64U} * 1024U;
+
+  auto out = std::string{};
+  if (coding == content_coding::GZIP) {
+    // magic, deflate, no flags, no mtime, no extra flags, unknown os
+    out.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10U);
+  }
+
+  // gzip: raw deflate stream + gzip header/trailer
+  // deflate: zlib stream (RFC 9110)
+  auto stream = mz_stream{};
+  utl::verify(
+      mz_deflateInit2(&stream, MZ_DEFAULT_LEVEL, MZ_DEFLATED,
+                      coding == content_coding::GZIP ? -MZ_DEFAULT_WINDOW_BITS
+                                                     : MZ_DEFAULT_WINDOW_BITS,
+                      9, MZ_DEFAULT_STRATEGY) == MZ_OK,
+      "compress: deflate init failed");
+
+  auto buf = std::vector<unsigned char>(kOutputBlockSize);
+  auto const* const data = reinterpret_cast<unsigned char const*>(input.data());
+  auto offset = std::size_t{0U};
+  auto flush = MZ_NO_FLUSH;
+  do {
+    auto const block_size = std::min(kInputBlockSize, input.size() - offset);
+    stream.next_in = data + offset;
+    stream.avail_in = static_cast<unsigned>(block_size);
+    offset += block_size;
+    flush = offset == input.size() ? MZ_FINISH : MZ_NO_FLUSH;
+
+    do {
+      stream.next_out = buf.data();
+      stream.avail_out = static_cast<unsigned>(buf.size());
+      auto const status = mz_deflate(&stream, flush);
+      if (status != MZ_OK && status != MZ_STREAM_END &&
+          status != MZ_BUF_ERROR) {
+        mz_deflateEnd(&stream);
+        throw utl::fail("compress: deflate failed: {}", status);
+      }
+      out.append(reinterpret_cast<char const*>(buf.data()),
+                 buf.size() - stream.avail_out);
+    } while (stream.avail_out == 0U);
+  } while (flush != MZ_FINISH);
+  mz_deflateEnd(&stream);
+
+  if (coding == content_coding::GZIP) {
+    append_le32(out, static_cast<std::uint32_t>(
+                         mz_crc32(MZ_CRC32_INIT, data, input.size())));
+    append_le32(out, static_cast<std::uint32_t>(input.size()));
+  }
+
+  return out;
+}
+
+}  // namespace motis::launcher
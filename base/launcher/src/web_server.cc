@@ -12,7 +12,6 @@
 #include "utl/helpers/algorithm.h"
 #include "utl/to_vec.h"
 
-#include "net/web_server/content_encoding.h"
 #include "net/web_server/responses.h"
 #include "net/web_server/serve_static.h"
 #include "net/web_server/web_server.h"
@@ -20,6 +19,7 @@
 #include "motis/core/common/logging.h"
 #include "motis/module/client.h"
 #include "motis/launcher/load_server_certificate.h"
+#include "motis/launcher/response_encoding.h"
 
 #if defined(NET_TLS)
 namespace ssl = boost::asio::ssl;
@@ -69,6 +69,30 @@ inline std::string_view to_sv(boost::beast::string_view const& bsv) {
   return {bsv.data(), bsv.size()};
 }
 
+// moves the content into the response body, compressed if the client
+// accepts it (the uncompressed content is released afterwards)
+void set_encoded_body(net::web_server::string_res_t& res,
+                      net::web_server::http_req_t const& req,
+                      std::string&& content) {
+  using boost::beast::http::field;
+  auto const negotiated = content.size() >= kMinCompressedResponseSize;
+  auto const coding =
+      negotiated ? select_content_coding(to_sv(req[field::accept_encoding]))
+                 : content_coding::IDENTITY;
+  if (negotiated) {
+    // caches must not serve an identity response to clients accepting gzip
+    // (or the other way round)
+    res.set(field::vary, "Accept-Encoding");
+  }
+  if (coding == content_coding::IDENTITY) {
+    res.body() = std::move(content);
+  } else {
+    res.set(field::content_encoding, to_str(coding));
+    res.body() = compress(content, coding);
+    content = std::string{};
+  }
+}
+
 struct ws_client : public client,
                    public std::enable_shared_from_this<ws_client> {
   ws_client(boost::asio::io_service& ios, net::ws_session_ptr session,
@@ -255,11 +279,11 @@ struct web_server::impl {
       }
 
       if (has_already_content_encoding) {
-        res.body() = content;
+        res.body() = std::move(content);
       } else {
-        net::set_response_body(res, req, content);
+        set_encoded_body(res, req, std::move(content));
       }
-      if (!content.empty()) {
+      if (!res.body().empty()) {
         res.prepare_payload();
       }
       return res;
@@ -288,7 +312,9 @@ struct web_server::impl {
       }
       case verb::head:
       case verb::get:
-        if (serve_static_files_ &&
+        if (metrics_provider_ && to_sv(req.target()) == "/metrics") {
+          return cb(build_metrics_response(req));
+        } else if (serve_static_files_ &&
             net::serve_static_file(static_file_path_, req, cb)) {
           return;
         } else {
@@ -304,6 +330,20 @@ struct web_server::impl {
     return on_msg_req(req_msg, false, to_sv(req.target()), res_cb);
   }
 
+  net::web_server::string_res_t build_metrics_response(
+      net::web_server::http_req_t const& req) const {
+    using namespace boost::beast::http;
+    net::web_server::string_res_t res{status::ok, req.version()};
+    res.set(field::content_type, "text/plain; version=0.0.4");
+    res.set(field::server, BOOST_BEAST_VERSION_STRING);
+    res.keep_alive(req.keep_alive());
+    if (req.method() != verb::head) {
+      set_encoded_body(res, req, metrics_provider_());
+    }
+    res.prepare_payload();
+    return res;
+  }
+
   void on_ws_open(net::ws_session_ptr session, std::string const& target) {
     LOG(logging::info) << "ws connection to \"" << target << "\"";
     if (target != "/") {
@@ -430,6 +470,8 @@ struct web_server::impl {
     }
   }
 
+  std::function<std::string()> metrics_provider_;
+
 private:
 #if defined(NET_TLS)
   ssl::context ctx_;
@@ -467,4 +509,8 @@ void web_server::listen(std::string const& host, std::string const& port,
 
 void web_server::stop() { impl_->stop(); }
 
+void web_server::set_metrics_provider(std::function<std::string()> fn) {
+  impl_->metrics_provider_ = std::move(fn);
+}
+
 }  // namespace motis::launcher
@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "miniz.h"
+
+#include "motis/launcher/response_encoding.h"
+
+using namespace motis::launcher;
+
+namespace {
+
+std::string make_input(std::size_t const size) {
+  auto s = std::string{};
+  s.reserve(size);
+  for (auto i = 0U; s.size() < size; ++i) {
+    s += R"({"station":")" + std::to_string(i % 97) + R"(","delay":)" +
+         std::to_string(i % 13) + "},";
+  }
+  s.resize(size);
+  return s;
+}
+
+std::string inflate(std::string_view const in, int const window_bits) {
+  auto stream = mz_stream{};
+  EXPECT_EQ(MZ_OK, mz_inflateInit2(&stream, window_bits));
+  stream.next_in = reinterpret_cast<unsigned char const*>(in.data());
+  stream.avail_in = static_cast<unsigned>(in.size());
+
+  auto out = std::string{};
+  auto buf = std::vector<unsigned char>(4096U);
+  auto status = MZ_OK;
+  do {
+    stream.next_out = buf.data();
+    stream.avail_out = static_cast<unsigned>(buf.size());
+    status = mz_inflate(&stream, MZ_NO_FLUSH);
+    EXPECT_TRUE(status == MZ_OK || status == MZ_STREAM_END);
+    out.append(reinterpret_cast<char const*>(buf.data()),
+               buf.size() - stream.avail_out);
+  } while (status == MZ_OK);
+  EXPECT_EQ(0U, stream.avail_in);
+  mz_inflateEnd(&stream);
+  return out;
+}
+
+std::uint32_t read_le32(std::string_view const s) {
+  auto v = std::uint32_t{0U};
+  for (auto i = 0U; i != 4U; ++i) {
+    v |= static_cast<std::uint32_t>(static_cast<unsigned char>(s[i]))
+         << (8U * i);
+  }
+  return v;
+}
+
+// RFC 1952: header, raw deflate stream, crc32 + input size
+std::string gunzip(std::string_view const in) {
+  EXPECT_GE(in.size(), 18U);
+  EXPECT_EQ('\x1f', in[0]);
+  EXPECT_EQ('\x8b', in[1]);
+  EXPECT_EQ(8, in[2]);  // deflate
+  EXPECT_EQ(0, in[3]);  // no optional header fields
+
+  auto const body = in.substr(10U, in.size() - 18U);
+  auto const out = inflate(body, -MZ_DEFAULT_WINDOW_BITS);
+
+  auto const trailer = in.substr(in.size() - 8U);
+  EXPECT_EQ(mz_crc32(MZ_CRC32_INIT,
+                     reinterpret_cast<unsigned char const*>(out.data()),
+                     out.size()),
+            read_le32(trailer));
+  EXPECT_EQ(static_cast<std::uint32_t>(out.size()),
+            read_le32(trailer.substr(4U)));
+  return out;
+}
+
+}  // namespace
+
+TEST(launcher_response_encoding, select_content_coding) {
+  EXPECT_EQ(content_coding::IDENTITY, select_content_coding(""));
+  EXPECT_EQ(content_coding::IDENTITY, select_content_coding("br, zstd"));
+  EXPECT_EQ(content_coding::GZIP, select_content_coding("gzip, deflate, br"));
+  EXPECT_EQ(content_coding::GZIP, select_content_coding("deflate, GZIP"));
+  EXPECT_EQ(content_coding::DEFLATE, select_content_coding("deflate"));
+  EXPECT_EQ(content_coding::GZIP, select_content_coding(" x-gzip "));
+
+  // q-values
+  EXPECT_EQ(content_coding::DEFLATE,
+            select_content_coding("gzip;q=0.5, deflate;q=0.8"));
+  EXPECT_EQ(content_coding::GZIP,
+            select_content_coding("gzip; q=0.8, deflate ;q=0.5"));
+  EXPECT_EQ(content_coding::DEFLATE,
+            select_content_coding("gzip;q=0, deflate"));
+  EXPECT_EQ(content_coding::IDENTITY,
+            select_content_coding("gzip;q=0.0, deflate;q=0"));
+
+  // identity
+  EXPECT_EQ(content_coding::IDENTITY,
+            select_content_coding("identity, gzip;q=0.5"));
+  EXPECT_EQ(content_coding::GZIP, select_content_coding("identity, gzip"));
+  EXPECT_EQ(content_coding::GZIP,
+            select_content_coding("identity;q=0, gzip;q=0.1"));
+
+  // wildcard
+  EXPECT_EQ(content_coding::GZIP, select_content_coding("*"));
+  EXPECT_EQ(content_coding::DEFLATE, select_content_coding("gzip;q=0, *"));
+  EXPECT_EQ(content_coding::IDENTITY, select_content_coding("*;q=0"));
+  EXPECT_EQ(content_coding::DEFLATE,
+            select_content_coding("*;q=0, deflate;q=0.2"));
+  EXPECT_EQ(content_coding::IDENTITY,
+            select_content_coding("identity, *;q=0.5"));
+}
+
+TEST(launcher_response_encoding, identity) {
+  auto const input = make_input(5000U);
+  EXPECT_EQ(input, compress(input, content_coding::IDENTITY));
+}
+
+TEST(launcher_response_encoding, gzip_round_trip) {
+  // empty, single block, multiple input blocks (1 MB each)
+  for (auto const size : {0U, 5000U, 3U * 1024U * 1024U + 17U}) {
+    auto const input = make_input(size);
+    auto const compressed = compress(input, content_coding::GZIP);
+    if (size != 0U) {
+      EXPECT_LT(compressed.size(), input.size());
+    }
+    EXPECT_EQ(input, gunzip(compressed));
+  }
+}
+
+TEST(launcher_response_encoding, deflate_round_trip) {
+  for (auto const size : {0U, 5000U, 3U * 1024U * 1024U + 17U}) {
+    auto const input = make_input(size);
+    auto const compressed = compress(input, content_coding::DEFLATE);
+    // zlib stream: CMF = deflate with 32K window, header checksum
+    ASSERT_GE(compressed.size(), 2U);
+    EXPECT_EQ(0x78, static_cast<unsigned char>(compressed[0]));
+    EXPECT_EQ(0U, ((static_cast<unsigned char>(compressed[0]) << 8U) |
+                   static_cast<unsigned char>(compressed[1])) %
+                      31U);
+    EXPECT_EQ(input, inflate(compressed, MZ_DEFAULT_WINDOW_BITS));
+  }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <string>
 
@@ -8,6 +9,9 @@
 
 namespace motis::loader::gtfs {
 
-void read_stop_times(loaded_file const&, trip_map&, stop_map const&);
+// the file is split into chunks of ~chunk_size bytes (at line boundaries)
+// which are parsed in parallel
+void read_stop_times(loaded_file const&, trip_map&, stop_map const&,
+                     std::size_t chunk_size = 16U * 1024U * 1024U);
 
 }  // namespace motis::loader::gtfs
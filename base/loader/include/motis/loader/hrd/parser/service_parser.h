@@ -21,4 +21,13 @@ void for_each_service(loaded_file const&, std::map<int, bitfield> const&,
                       std::function<void(std::size_t)> bytes_consumed,
                       config const&);
 
+// same as for_each_service, but the file is split into chunks (at service
+// boundaries) that are parsed in parallel - the consumer is still called
+// sequentially and in file order
+void for_each_service_parallel(
+    loaded_file const&, std::map<int, bitfield> const&,
+    std::function<void(hrd_service const&)>,
+    std::function<void(std::size_t)> bytes_consumed, config const&,
+    std::size_t chunk_size = 4U * 1024U * 1024U);
+
 }  // namespace motis::loader::hrd
@@ -11,6 +11,7 @@
 #include "utl/parallel_for.h"
 #include "utl/verify.h"
 
+#include "motis/core/common/all_pairs_dial.h"
 #include "motis/core/common/floyd_warshall.h"
 #include "motis/core/common/logging.h"
 #include "motis/core/schedule/price.h"
@@ -53,6 +54,10 @@ constexpr auto const kAdjustedMaxDuration = 15;  // [minutes]
 
 constexpr auto kNoComponent = std::numeric_limits<uint32_t>::max();
 
+// components with more than (stations^2 / kDenseFactor) footpaths are
+// transitivized using floyd warshall, sparser ones using dijkstra
+constexpr auto const kDenseFactor = std::size_t{16U};
+
 // station_idx -> [footpath, ...]
 using footgraph = std::vector<std::vector<footpath>>;
 
@@ -365,6 +370,7 @@ struct footpath_builder {
         std::numeric_limits<std::uint8_t>::max();
     auto mat = make_std_flat_matrix<std::uint8_t>(size, kInvalidTime);
 
+    auto edge_count = std::size_t{0U};
     for (auto i = 0; i < size; ++i) {
       auto it = lb;
       for (auto const& edge : fgraph[(lb + i)->second]) {  // precond.: sorted!
@@ -373,6 +379,7 @@ struct footpath_builder {
         }
         auto j = std::distance(lb, it);
         mat(i, j) = edge.duration_;
+        ++edge_count;
       }
     }
 
@@ -424,7 +431,14 @@ struct footpath_builder {
 
     print_dbg("MOTIS MAT BEFORE\n{}\n", mat);
 
-    floyd_warshall(mat);
+    // one dijkstra per station is cheaper than the (vectorized) cubic
+    // floyd warshall if the average number of footpaths per station is small
+    // compared to the component size
+    if (edge_count * kDenseFactor < static_cast<std::size_t>(size) * size) {
+      all_pairs_dial(mat);
+    } else {
+      floyd_warshall_blocked(mat);
+    }
 
     print_dbg("MOTIS MAT AFTER\n{}", mat);
 
@@ -1,9 +1,15 @@
 #include "motis/loader/gtfs/stop_time.h"
 
 #include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <string_view>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include "utl/enumerate.h"
+#include "utl/parallel_for.h"
 #include "utl/parser/arg_parser.h"
 #include "utl/parser/csv.h"
 #include "utl/progress_tracker.h"
@@ -33,58 +39,182 @@ static const column_mapping<gtfs_stop_time> stop_time_columns = {
     {"trip_id", "arrival_time", "departure_time", "stop_id", "stop_sequence",
      "stop_headsign", "pickup_type", "drop_off_type"}};
 
-void read_stop_times(loaded_file const& file, trip_map& trips,
-                     stop_map const& stops) {
-  motis::logging::scoped_timer const timer{"read stop times"};
-  std::string last_trip_id;
-  trip* last_trip = nullptr;
+namespace {
+
+// stop time with resolved trip and stop (nullptr if not found)
+struct parsed_stop_time {
+  trip* trip_{nullptr};
+  stop* stop_{nullptr};
+  int stop_sequence_{};
+  std::string headsign_;
+  int arr_time_{}, dep_time_{};
+  bool out_allowed_{}, in_allowed_{};
+  std::string unknown_id_;  // for error messages
+};
 
-  auto const entries = read<gtfs_stop_time>(file.content(), stop_time_columns);
+// splits the content at line boundaries into chunks of ~chunk_size bytes
+std::vector<cstr> split_lines(cstr const content,
+                              std::size_t const chunk_size) {
+  auto chunks = std::vector<cstr>{};
+  auto const* const content_end = content.str + content.len;
+  auto const* chunk_begin = content.str;
+  while (chunk_begin != content_end) {
+    auto const* chunk_end = content_end;
+    if (static_cast<std::size_t>(content_end - chunk_begin) > chunk_size) {
+      chunk_end = std::find(chunk_begin + chunk_size, content_end, '\n');
+      if (chunk_end != content_end) {
+        ++chunk_end;
+      }
+    }
+    chunks.emplace_back(chunk_begin,
+                        static_cast<std::size_t>(chunk_end - chunk_begin));
+    chunk_begin = chunk_end;
+  }
+  return chunks;
+}
 
-  auto progress_tracker = utl::get_active_progress_tracker();
-  progress_tracker->status("Parse Stop Times")
-      .out_bounds(25.F, 60.F)
-      .in_high(entries.size());
+std::vector<parsed_stop_time> parse_stop_times(std::string_view const header,
+                                               cstr const chunk,
+                                               trip_map const& trips,
+                                               stop_map const& stops) {
+  // every chunk is parsed as a separate csv file with the original header
+  auto buf = std::string{header};
+  buf.append(chunk.str, chunk.len);
+  auto const entries =
+      read<gtfs_stop_time>(cstr{buf.data(), buf.size()}, stop_time_columns);
+
+  auto parsed = std::vector<parsed_stop_time>(entries.size());
+  trip* last_trip = nullptr;
+  cstr last_trip_id;
   for (auto const& [i, s] : utl::enumerate(entries)) {
-    progress_tracker->update(i);
-
-    trip* t = nullptr;
-    auto t_id = get<trip_id>(s).to_str();
-    if (last_trip != nullptr && t_id == last_trip_id) {
-      t = last_trip;
+    auto& p = parsed[i];
+    if (last_trip != nullptr && get<trip_id>(s) == last_trip_id) {
+      p.trip_ = last_trip;
     } else {
-      if (last_trip != nullptr) {
-        last_trip->to_line_ = i + 1;
-      }
-
-      auto const trip_it = trips.find(t_id);
-      if (trip_it == end(trips)) {
-        LOG(logging::error) << "trip \"" << t_id << "\" in " << file.name()
-                            << ":" << i << " not found";
+      auto const t_id = get<trip_id>(s).to_str();
+      if (auto const it = trips.find(t_id); it != end(trips)) {
+        p.trip_ = it->second.get();
+        last_trip = p.trip_;
+        last_trip_id = get<trip_id>(s);
+      } else {
+        p.unknown_id_ = t_id;
         continue;
       }
-      t = trip_it->second.get();
-      last_trip_id = t_id;
-      last_trip = t;
+    }
 
-      t->from_line_ = i + 2;
+    if (auto const it = stops.find(get<stop_id>(s).to_str());
+        it != end(stops)) {
+      p.stop_ = it->second.get();
+    } else {
+      p.unknown_id_ = get<stop_id>(s).to_str();
+      continue;
     }
+    p.stop_sequence_ = get<stop_sequence>(s);
+    p.headsign_ = get<stop_headsign>(s).to_str();
+    p.arr_time_ = hhmm_to_min(get<arrival_time>(s));
+    p.out_allowed_ = get<drop_off_type>(s) != 1;
+    p.dep_time_ = hhmm_to_min(get<departure_time>(s));
+    p.in_allowed_ = get<pickup_type>(s) != 1;
+  }
+  return parsed;
+}
+
+}  // namespace
+
+void read_stop_times(loaded_file const& file, trip_map& trips,
+                     stop_map const& stops, std::size_t const chunk_size) {
+  motis::logging::scoped_timer const timer{"read stop times"};
+  auto const start = std::chrono::steady_clock::now();
+
+  auto const content = file.content();
+  auto const* const header_end =
+      std::find(content.str, content.str + content.len, '\n');
+  if (header_end == content.str + content.len) {
+    return;
+  }
+  auto const header =
+      std::string_view{content.str,
+                       static_cast<std::size_t>(header_end + 1 - content.str)};
+  auto const chunks =
+      split_lines(cstr{header_end + 1, static_cast<std::size_t>(
+                                           content.str + content.len -
+                                           (header_end + 1))},
+                  std::max(chunk_size, std::size_t{1U}));
 
-    try {
-      t->stop_times_.emplace(
-          get<stop_sequence>(s), stops.at(get<stop_id>(s).to_str()).get(),
-          get<stop_headsign>(s).to_str(),  //
-          hhmm_to_min(get<arrival_time>(s)), get<drop_off_type>(s) != 1,
-          hhmm_to_min(get<departure_time>(s)), get<pickup_type>(s) != 1);
-    } catch (...) {
-      LOG(logging::warn) << "unknown stop " << get<stop_id>(s).to_str()
-                         << " at " << file.name() << ":" << i;
+  auto progress_tracker = utl::get_active_progress_tracker();
+  progress_tracker->status("Parse Stop Times")
+      .out_bounds(25.F, 60.F)
+      .in_high(content.len);
+
+  // chunks are parsed in parallel (csv parsing + trip and stop lookup),
+  // stop times are added to the trips sequentially in file order
+  auto const chunk_count = static_cast<unsigned>(chunks.size());
+  auto const batch_size =
+      std::max(1U, std::thread::hardware_concurrency()) * 2U;
+  auto i = std::size_t{0U};
+  trip* last_trip = nullptr;
+  for (auto batch_begin = 0U; batch_begin < chunk_count;
+       batch_begin += batch_size) {
+    auto const batch_end = std::min(chunk_count, batch_begin + batch_size);
+    auto chunk_indices = std::vector<unsigned>(batch_end - batch_begin);
+    std::iota(begin(chunk_indices), end(chunk_indices), batch_begin);
+    auto parsed = std::vector<std::vector<parsed_stop_time>>(
+        chunk_indices.size());
+    utl::parallel_for(chunk_indices, [&](unsigned const chunk_idx) {
+      parsed[chunk_idx - batch_begin] =
+          parse_stop_times(header, chunks[chunk_idx], trips, stops);
+    });
+
+    for (auto& chunk_stop_times : parsed) {
+      for (auto& p : chunk_stop_times) {
+        auto const line = i++;
+        trip* t = nullptr;
+        if (last_trip != nullptr && p.trip_ == last_trip) {
+          t = last_trip;
+        } else {
+          if (last_trip != nullptr) {
+            last_trip->to_line_ = line + 1;
+          }
+
+          if (p.trip_ == nullptr) {
+            LOG(logging::error) << "trip \"" << p.unknown_id_ << "\" in "
+                                << file.name() << ":" << line << " not found";
+            continue;
+          }
+          t = p.trip_;
+          last_trip = t;
+
+          t->from_line_ = line + 2;
+        }
+
+        if (p.stop_ == nullptr) {
+          LOG(logging::warn) << "unknown stop " << p.unknown_id_ << " at "
+                             << file.name() << ":" << line;
+          continue;
+        }
+        t->stop_times_.emplace(p.stop_sequence_, p.stop_,
+                               std::move(p.headsign_), p.arr_time_,
+                               p.out_allowed_, p.dep_time_, p.in_allowed_);
+      }
     }
+
+    auto const& last_chunk = chunks[batch_end - 1];
+    progress_tracker->update(
+        static_cast<std::size_t>(last_chunk.str + last_chunk.len -
+                                 content.str));
   }
 
   if (last_trip != nullptr) {
-    last_trip->to_line_ = entries.size() + 1;
+    last_trip->to_line_ = i + 1;
   }
+
+  auto const seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  LOG(logging::info) << "read stop times: " << i << " entries, "
+                     << (static_cast<double>(content.len) / (1024.0 * 1024.0) /
+                         std::max(seconds, 1e-6))
+                     << " MB/s";
 }
 
 }  // namespace motis::loader::gtfs
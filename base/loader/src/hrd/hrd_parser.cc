@@ -180,8 +180,8 @@ void parse_and_build_services(
               << schedule_data.back()->name();
 
     try {
-      for_each_service(*loaded, bitfields, service_builder_fun, progress_update,
-                       c);
+      for_each_service_parallel(*loaded, bitfields, service_builder_fun,
+                                progress_update, c);
     } catch (parser_error const& e) {
       LOG(error) << "unable to parse " << e.filename_copy_ << " (error in line "
                  << e.line_number_ << ")";
@@ -2,7 +2,11 @@
 
 #include <cctype>
 #include <algorithm>
+#include <exception>
+#include <numeric>
+#include <thread>
 
+#include "utl/parallel_for.h"
 #include "utl/verify.h"
 
 #include "motis/core/common/logging.h"
@@ -17,57 +21,145 @@ using namespace motis::logging;
 
 namespace motis::loader::hrd {
 
-void parse_specification(loaded_file const& file,
-                         std::function<void(specification const&)> builder,
-                         std::function<void(std::size_t)> bytes_consumed) {
-  specification spec;
-  auto last_line = 0U;
-  for_each_line_numbered(file.content(), [&](cstr line, int line_number) {
-    last_line = line_number;
-    bytes_consumed(line.c_str() - file.content().c_str());
+void expand_and_consume(
+    hrd_service&& non_expanded_service,
+    std::map<int, bitfield> const& bitfields,
+    std::function<void(hrd_service const&)> const& consumer) {
+  std::vector<hrd_service> expanded_services;
+  expand_traffic_days(non_expanded_service, bitfields, expanded_services);
+  expand_repetitions(expanded_services);
+  for (auto const& s : expanded_services) {
+    consumer(std::cref(s));
+  }
+}
 
-    bool const finished = spec.read_line(line, file.name(), line_number);
+namespace {
 
-    if (!finished) {
-      return;
+// services start with *Z, *T or *K (but not *KWZ) lines
+bool is_service_start(cstr const line) {
+  return line.len >= 2 && line[0] == '*' &&
+         (line[1] == 'Z' || line[1] == 'T' ||
+          (line[1] == 'K' && !(line.len > 3 && line[3] == 'Z')));
+}
+
+// file part that starts at a service boundary
+struct service_chunk {
+  cstr content_;
+  int line_offset_{};
+};
+
+std::vector<service_chunk> split_at_services(cstr const content,
+                                             std::size_t const chunk_size) {
+  auto chunks = std::vector<service_chunk>{};
+  auto const* const content_end = content.str + content.len;
+  auto const* chunk_begin = content.str;
+  auto line_offset = 0;
+  while (chunk_begin != content_end) {
+    auto const* chunk_end = chunk_begin;
+    if (static_cast<std::size_t>(content_end - chunk_begin) <= chunk_size) {
+      chunk_end = content_end;
     } else {
-      spec.line_number_to_ = line_number - 1;
+      chunk_end = std::find(chunk_begin + chunk_size, content_end, '\n');
+      while (chunk_end != content_end) {
+        ++chunk_end;  // skip newline
+        auto const* const line_end = std::find(chunk_end, content_end, '\n');
+        auto const line_length =
+            static_cast<std::size_t>(line_end - chunk_end);
+        if (is_service_start(cstr{chunk_end, line_length})) {
+          break;
+        }
+        chunk_end = line_end;
+      }
     }
+    chunks.emplace_back(service_chunk{
+        cstr{chunk_begin, static_cast<std::size_t>(chunk_end - chunk_begin)},
+        line_offset});
+    line_offset += static_cast<int>(std::count(chunk_begin, chunk_end, '\n'));
+    chunk_begin = chunk_end;
+  }
+  return chunks;
+}
 
+void parse_specification(
+    cstr const content, char const* filename, int const line_offset,
+    bool const is_file_end,
+    std::function<void(specification const&)> const& builder,
+    std::function<void(std::size_t)> const& bytes_consumed) {
+  specification spec;
+  auto last_line = 0;
+
+  auto const build = [&](int const line_number) {
     if (!spec.valid()) {
-      LOG(error) << "skipping bad service at " << file.name() << ":"
+      LOG(error) << "skipping bad service at " << filename << ":"
                  << line_number;
     } else if (!spec.ignore()) {
       // Store if relevant.
       try {
         builder(spec);
       } catch (std::runtime_error const& e) {
-        LOG(error) << "unable to build service at " << file.name() << ":"
+        LOG(error) << "unable to build service at " << filename << ":"
                    << line_number << ", skipping";
       }
     }
+  };
+
+  for_each_line_numbered(content, [&](cstr line, int line_number) {
+    line_number += line_offset;
+    last_line = line_number;
+    bytes_consumed(line.c_str() - content.c_str());
+
+    bool const finished = spec.read_line(line, filename, line_number);
+
+    if (!finished) {
+      return;
+    } else {
+      spec.line_number_to_ = line_number - 1;
+    }
+
+    build(line_number);
 
     // Next try! Re-read first line of next service.
     spec.reset();
-    spec.read_line(line, file.name(), line_number);
+    spec.read_line(line, filename, line_number);
   });
 
-  if (!spec.is_empty() && spec.valid() && !spec.ignore()) {
-    spec.line_number_to_ = last_line;
+  if (spec.is_empty()) {
+    return;
+  }
+  spec.line_number_to_ = last_line;
+  if (!is_file_end) {
+    // the next chunk starts with a new service
+    build(last_line + 1);
+  } else if (spec.valid() && !spec.ignore()) {
     builder(spec);
   }
 }
 
-void expand_and_consume(
-    hrd_service&& non_expanded_service,
+std::function<void(specification const&)> service_builder(
     std::map<int, bitfield> const& bitfields,
-    std::function<void(hrd_service const&)> const& consumer) {
-  std::vector<hrd_service> expanded_services;
-  expand_traffic_days(non_expanded_service, bitfields, expanded_services);
-  expand_repetitions(expanded_services);
-  for (auto const& s : expanded_services) {
-    consumer(std::cref(s));
-  }
+    std::function<void(hrd_service const&)> consumer, config const& c) {
+  return [&bitfields, consumer = std::move(consumer),
+          &c](specification const& spec) {
+    try {
+      expand_and_consume(hrd_service(spec, c), bitfields, consumer);
+    } catch (parser_error const& e) {
+      LOG(error) << "skipping bad service at " << e.filename_ << ":"
+                 << e.line_number_;
+    } catch (std::runtime_error const& e) {
+      LOG(error) << "skipping bad service at " << spec.filename_ << ":"
+                 << spec.line_number_from_ << "-" << spec.line_number_to_
+                 << ": " << e.what();
+    }
+  };
+}
+
+}  // namespace
+
+void parse_specification(loaded_file const& file,
+                         std::function<void(specification const&)> builder,
+                         std::function<void(std::size_t)> bytes_consumed) {
+  parse_specification(file.content(), file.name(), 0, true, builder,
+                      bytes_consumed);
 }
 
 void for_each_service(loaded_file const& file,
@@ -75,21 +167,69 @@ void for_each_service(loaded_file const& file,
                       std::function<void(hrd_service const&)> consumer,
                       std::function<void(std::size_t)> bytes_consumed,
                       config const& c) {
-  parse_specification(
-      file,
-      [&](specification const& spec) {
-        try {
-          expand_and_consume(hrd_service(spec, c), bitfields, consumer);
-        } catch (parser_error const& e) {
-          LOG(error) << "skipping bad service at " << e.filename_ << ":"
-                     << e.line_number_;
-        } catch (std::runtime_error const& e) {
-          LOG(error) << "skipping bad service at " << spec.filename_ << ":"
-                     << spec.line_number_from_ << "-" << spec.line_number_to_
-                     << ": " << e.what();
-        }
-      },
-      std::move(bytes_consumed));
+  parse_specification(file, service_builder(bitfields, consumer, c),
+                      std::move(bytes_consumed));
+}
+
+void for_each_service_parallel(loaded_file const& file,
+                               std::map<int, bitfield> const& bitfields,
+                               std::function<void(hrd_service const&)> consumer,
+                               std::function<void(std::size_t)> bytes_consumed,
+                               config const& c, std::size_t const chunk_size) {
+  auto const chunks = split_at_services(file.content(), chunk_size);
+  if (chunks.size() <= 1U) {
+    return for_each_service(file, bitfields, std::move(consumer),
+                            std::move(bytes_consumed), c);
+  }
+
+  struct chunk_result {
+    std::vector<hrd_service> services_;
+    std::exception_ptr error_;
+  };
+
+  // chunks are parsed in parallel, but services are always consumed in file
+  // order (the output has to be identical to sequential parsing),
+  // only a limited number of chunks is kept in memory
+  auto const chunk_count = static_cast<unsigned>(chunks.size());
+  auto const batch_size =
+      std::max(1U, std::thread::hardware_concurrency()) * 2U;
+  for (auto batch_begin = 0U; batch_begin < chunk_count;
+       batch_begin += batch_size) {
+    auto const batch_end = std::min(chunk_count, batch_begin + batch_size);
+    auto chunk_indices = std::vector<unsigned>(batch_end - batch_begin);
+    std::iota(begin(chunk_indices), end(chunk_indices), batch_begin);
+    auto results = std::vector<chunk_result>(chunk_indices.size());
+
+    utl::parallel_for(chunk_indices, [&](unsigned const chunk_idx) {
+      auto const& chunk = chunks[chunk_idx];
+      auto& result = results[chunk_idx - batch_begin];
+      try {
+        parse_specification(
+            chunk.content_, file.name(), chunk.line_offset_,
+            chunk_idx == chunk_count - 1,
+            service_builder(
+                bitfields,
+                [&](hrd_service const& s) { result.services_.push_back(s); },
+                c),
+            [](std::size_t) {});
+      } catch (...) {
+        result.error_ = std::current_exception();
+      }
+    });
+
+    for (auto const& result : results) {
+      for (auto const& s : result.services_) {
+        consumer(s);
+      }
+      if (result.error_) {
+        std::rethrow_exception(result.error_);
+      }
+    }
+
+    auto const& last_chunk = chunks[batch_end - 1].content_;
+    bytes_consumed(static_cast<std::size_t>(last_chunk.str + last_chunk.len -
+                                            file.content().str));
+  }
 }
 
 }  // namespace motis::loader::hrd
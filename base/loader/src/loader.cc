@@ -1,7 +1,12 @@
 #include "motis/loader/loader.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -13,12 +18,14 @@
 
 #include "flatbuffers/flatbuffers.h"
 
+#include "cista/hash.h"
 #include "cista/mmap.h"
 
 #include "utl/enumerate.h"
 #include "utl/overloaded.h"
 #include "utl/parser/file.h"
 #include "utl/progress_tracker.h"
+#include "utl/to_vec.h"
 #include "utl/verify.h"
 
 #include "motis/core/common/logging.h"
@@ -45,6 +52,67 @@ std::vector<std::unique_ptr<format_parser>> parsers() {
 
 using dataset_mem_t = std::variant<cista::mmap, typed_flatbuffer<Schedule>>;
 
+namespace {
+
+// cheap fingerprint of a dataset (all files: path, size, modification time)
+// used to detect which datasets changed since their binary schedule was
+// written
+cista::hash_t dataset_input_hash(fs::path const& path) {
+  auto hash = cista::BASE_HASH;
+  auto const add_file = [&](fs::path const& p) {
+    auto ec = std::error_code{};
+    auto const size = fs::file_size(p, ec);
+    auto const time = fs::last_write_time(p, ec).time_since_epoch().count();
+    hash = cista::hash_combine(
+        cista::hash(std::string_view{p.generic_string()}, hash), size,
+        static_cast<std::int64_t>(time));
+  };
+
+  if (fs::is_regular_file(path)) {
+    add_file(path);
+  } else if (fs::is_directory(path)) {
+    auto files = std::vector<fs::path>{};
+    for (auto const& e : fs::recursive_directory_iterator{path}) {
+      if (e.is_regular_file()) {
+        files.emplace_back(e.path());
+      }
+    }
+    std::sort(begin(files), end(files));
+    for (auto const& f : files) {
+      add_file(f);
+    }
+  }
+  return hash;
+}
+
+std::string input_hash_path(std::string const& binary_schedule_file) {
+  return binary_schedule_file + ".input_hash";
+}
+
+std::optional<cista::hash_t> read_input_hash(
+    std::string const& binary_schedule_file) {
+  auto in = std::ifstream{input_hash_path(binary_schedule_file)};
+  auto hash = cista::hash_t{};
+  if (in >> hash) {
+    return hash;
+  }
+  return std::nullopt;
+}
+
+void write_input_hash(std::string const& binary_schedule_file,
+                      cista::hash_t const hash) {
+  std::ofstream{input_hash_path(binary_schedule_file)} << hash;
+}
+
+// binary schedules written without an input hash are always reused
+bool is_up_to_date(std::string const& binary_schedule_file,
+                   cista::hash_t const input_hash) {
+  auto const stored_hash = read_input_hash(binary_schedule_file);
+  return !stored_hash.has_value() || *stored_hash == input_hash;
+}
+
+}  // namespace
+
 schedule_ptr load_schedule_impl(loader_options const& loader_opt,
                                 cista::memory_holder& schedule_buf,
                                 std::string const& data_dir) {
@@ -53,11 +121,36 @@ schedule_ptr load_schedule_impl(loader_options const& loader_opt,
   // ensure there is an active progress tracker (e.g. for test cases)
   utl::get_active_progress_tracker_or_activate("schedule");
 
+  // only datasets that changed since their binary schedule was written are
+  // parsed again
+  auto const input_hashes =
+      utl::to_vec(loader_opt.dataset_, [](std::string const& path) {
+        return dataset_input_hash(path);
+      });
+  auto changed_datasets = std::vector<bool>(loader_opt.dataset_.size());
+  for (auto i = 0U; i < loader_opt.dataset_.size(); ++i) {
+    auto const binary_schedule_file = loader_opt.fbs_schedule_path(data_dir, i);
+    changed_datasets[i] =
+        fs::is_regular_file(binary_schedule_file) &&
+        !is_up_to_date(binary_schedule_file, input_hashes[i]);
+    if (changed_datasets[i] && !loader_opt.write_serialized_) {
+      // the binary schedule (and its input hash) would not be replaced:
+      // parsing again would repeat on every start and bypass the graph cache
+      LOG(ml::warn) << "dataset " << loader_opt.dataset_[i]
+                    << " changed, but write_serialized is disabled: using "
+                    << binary_schedule_file;
+      changed_datasets[i] = false;
+    }
+  }
+  auto const any_dataset_changed =
+      std::any_of(begin(changed_datasets), end(changed_datasets),
+                  [](bool const changed) { return changed; });
+
   auto const graph_path = loader_opt.graph_path(data_dir);
   auto enable_read_graph = loader_opt.read_graph_;
   auto enable_write_graph = loader_opt.write_graph_;
   if (loader_opt.cache_graph_) {
-    enable_read_graph = fs::is_regular_file(graph_path);
+    enable_read_graph = fs::is_regular_file(graph_path) && !any_dataset_changed;
     enable_write_graph = true;
   }
   if (enable_read_graph) {
@@ -87,10 +180,12 @@ schedule_ptr load_schedule_impl(loader_options const& loader_opt,
   mem.reserve(loader_opt.dataset_.size());
   for (auto const& [i, path] : utl::enumerate(loader_opt.dataset_)) {
     auto const binary_schedule_file = loader_opt.fbs_schedule_path(data_dir, i);
-    if (fs::is_regular_file(binary_schedule_file)) {
+    if (fs::is_regular_file(binary_schedule_file) && !changed_datasets[i]) {
       mem.emplace_back(cista::mmap{binary_schedule_file.c_str(),
                                    cista::mmap::protection::READ});
       continue;
+    } else if (changed_datasets[i]) {
+      LOG(ml::info) << "dataset " << path << " changed, parsing again";
     }
 
     auto const all_parsers = parsers();
@@ -134,6 +229,7 @@ schedule_ptr load_schedule_impl(loader_options const& loader_opt,
       }
       utl::file(binary_schedule_file.c_str(), "w+")
           .write(builder.GetBufferPointer(), builder.GetSize());
+      write_input_hash(binary_schedule_file, input_hashes[i]);
     }
 
     mem.emplace_back(typed_flatbuffer<Schedule>{std::move(builder)});
@@ -81,4 +81,46 @@ TEST(loader_gtfs_route, read_stop_times_example_data) {
   EXPECT_EQ(357U, i);
 }
 
+TEST(loader_gtfs_route, read_stop_times_chunked) {
+  auto agencies =
+      read_agencies(loaded_file{SCHEDULES / "example" / AGENCY_FILE});
+  auto routes =
+      read_routes(loaded_file{SCHEDULES / "example" / ROUTES_FILE}, agencies);
+  auto dates = read_calendar_date(
+      loaded_file{SCHEDULES / "example" / CALENDAR_DATES_FILE});
+  auto calendar =
+      read_calendar(loaded_file{SCHEDULES / "example" / CALENDAR_FILE});
+  auto traffic_days = merge_traffic_days(calendar, dates);
+  auto stops = read_stops(loaded_file{SCHEDULES / "example" / STOPS_FILE});
+  auto const stop_times_file =
+      loaded_file{SCHEDULES / "example" / STOP_TIMES_FILE};
+
+  auto [expected, expected_blocks] = read_trips(
+      loaded_file{SCHEDULES / "example" / TRIPS_FILE}, routes, traffic_days);
+  read_stop_times(stop_times_file, expected, stops);
+
+  for (auto const chunk_size : {1U, 50U, 200U}) {
+    auto [trips, blocks] = read_trips(
+        loaded_file{SCHEDULES / "example" / TRIPS_FILE}, routes, traffic_days);
+    read_stop_times(stop_times_file, trips, stops, chunk_size);
+
+    ASSERT_EQ(expected.size(), trips.size());
+    for (auto const& [id, t] : trips) {
+      auto const& e = expected.at(id);
+      EXPECT_EQ(e->from_line_, t->from_line_) << id;
+      EXPECT_EQ(e->to_line_, t->to_line_) << id;
+      ASSERT_EQ(e->stop_times_.size(), t->stop_times_.size()) << id;
+      for (auto const& [seq, st] : t->stop_times_) {
+        auto const& est = e->stop_times_[seq];
+        EXPECT_EQ(est.stop_, st.stop_);
+        EXPECT_EQ(est.headsign_, st.headsign_);
+        EXPECT_EQ(est.arr_.time_, st.arr_.time_);
+        EXPECT_EQ(est.dep_.time_, st.dep_.time_);
+        EXPECT_EQ(est.arr_.in_out_allowed_, st.arr_.in_out_allowed_);
+        EXPECT_EQ(est.dep_.in_out_allowed_, st.dep_.in_out_allowed_);
+      }
+    }
+  }
+}
+
 }  // namespace motis::loader::gtfs
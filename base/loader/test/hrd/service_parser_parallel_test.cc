@@ -0,0 +1,64 @@
+#include <cinttypes>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "motis/loader/hrd/parser/bitfields_parser.h"
+#include "motis/loader/hrd/parser/service_parser.h"
+
+#include "./paths.h"
+#include "./test_spec_test.h"
+
+namespace motis::loader::hrd {
+
+namespace {
+
+struct service_id {
+  int line_number_from_;
+  int line_number_to_;
+  int initial_train_num_;
+  int num_repetitions_;
+  std::size_t stops_;
+  bitfield traffic_days_;
+
+  friend bool operator==(service_id const& a, service_id const& b) {
+    return a.line_number_from_ == b.line_number_from_ &&
+           a.line_number_to_ == b.line_number_to_ &&
+           a.initial_train_num_ == b.initial_train_num_ &&
+           a.num_repetitions_ == b.num_repetitions_ && a.stops_ == b.stops_ &&
+           a.traffic_days_ == b.traffic_days_;
+  }
+};
+
+service_id get_id(hrd_service const& s) {
+  return service_id{s.origin_.line_number_from_, s.origin_.line_number_to_,
+                    s.initial_train_num_,        s.num_repetitions_,
+                    s.stops_.size(),             s.traffic_days_};
+}
+
+}  // namespace
+
+TEST(loader_hrd_service_parser, parallel_matches_sequential) {
+  test_spec const b_spec(SCHEDULES / "ts-mss-hrd" / "stamm", "bitfield.101");
+  auto const bitfields = parse_bitfields(b_spec.lf_, hrd_5_00_8);
+  test_spec const services_spec(SCHEDULES / "ts-mss-hrd" / "fahrten",
+                                "services_03056.101");
+
+  std::vector<service_id> sequential;
+  for_each_service(
+      services_spec.lf_, bitfields,
+      [&](hrd_service const& s) { sequential.emplace_back(get_id(s)); },
+      [](std::size_t) {}, hrd_5_00_8);
+  ASSERT_FALSE(sequential.empty());
+
+  for (auto const chunk_size : {1U, 100U, 1000U, 1024U * 1024U}) {
+    std::vector<service_id> parallel;
+    for_each_service_parallel(
+        services_spec.lf_, bitfields,
+        [&](hrd_service const& s) { parallel.emplace_back(get_id(s)); },
+        [](std::size_t) {}, hrd_5_00_8, chunk_size);
+    EXPECT_TRUE(sequential == parallel) << "chunk_size=" << chunk_size;
+  }
+}
+
+}  // namespace motis::loader::hrd
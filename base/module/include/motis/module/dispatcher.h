@@ -10,8 +10,11 @@
 #include "motis/module/ctx_data.h"
 #include "motis/module/future.h"
 #include "motis/module/message.h"
+#include "motis/module/op_metrics.h"
+#include "motis/module/op_scheduler.h"
 #include "motis/module/receiver.h"
 #include "motis/module/registry.h"
+#include "motis/module/response_cache.h"
 #include "motis/module/timer.h"
 
 namespace motis::module {
@@ -52,6 +55,9 @@ struct dispatcher : public receiver, public ctx::access_scheduler<ctx_data> {
 
   motis::module::msg_ptr api_desc(int id) const;
 
+  // operation and scheduler metrics in the Prometheus text format
+  std::string prometheus_metrics() const;
+
   void handle_no_target(msg_ptr const& msg, callback const& cb);
   void retry_no_target_msgs();
 
@@ -61,6 +67,14 @@ struct dispatcher : public receiver, public ctx::access_scheduler<ctx_data> {
   std::vector<std::unique_ptr<module>> modules_;
   std::map<std::string, std::shared_ptr<timer>> timers_;
 
+  // admission control for top-level requests (nested requests bypass it)
+  op_scheduler scheduler_;
+
+  op_metrics metrics_;
+
+  // responses of operations registered with a cache ttl
+  response_cache cache_;
+
   // If this is set to a value != nullptr, it indicates direct mode is on.
   // This implies that in direct mode there can only be one global dispatcher.
   // Direct mode means that
@@ -14,7 +14,9 @@ enum error_code_t {
   unknown_error = 4,
   unexpected_message_type = 5,
   null_message_content_access = 6,
-  remote_error = 7
+  remote_error = 7,
+  too_many_requests = 8,
+  latency_budget_exceeded = 9
 };
 }  // namespace error
 
@@ -31,6 +33,9 @@ public:
       case error::unexpected_message_type:
         return "module: unexpected message type";
       case error::remote_error: return "module: remote execution error";
+      case error::too_many_requests: return "module: too many requests";
+      case error::latency_budget_exceeded:
+        return "module: latency budget exceeded";
       case error::unknown_error:
       default: return "module: unknown error";
     }
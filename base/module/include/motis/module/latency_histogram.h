@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace motis::module {
+
+// Lock-free log-linear (HDR-style) histogram for durations in microseconds.
+// Every power of two is split into 2^kSubBucketBits sub-buckets which gives a
+// relative error of at most 1/2^kSubBucketBits.
+struct latency_histogram {
+  static constexpr auto const kSubBucketBits = 3U;
+  static constexpr auto const kSubBuckets = 1ULL << kSubBucketBits;
+  static constexpr auto const kMaxBits = 36U;  // ~19h
+  static constexpr auto const kBuckets =
+      (kMaxBits - kSubBucketBits + 1U) * kSubBuckets;
+
+  static constexpr std::size_t bucket_idx(std::uint64_t const us) {
+    if (us < kSubBuckets) {
+      return static_cast<std::size_t>(us);
+    }
+    auto msb = 0U;
+    while ((us >> (msb + 1U)) != 0U) {
+      ++msb;
+    }
+    if (msb >= kMaxBits) {
+      return kBuckets - 1U;
+    }
+    auto const shift = msb - kSubBucketBits;
+    return static_cast<std::size_t>((shift + 1U) * kSubBuckets +
+                                    ((us >> shift) - kSubBuckets));
+  }
+
+  // exclusive upper bound of the values in the given bucket
+  static constexpr std::uint64_t bucket_end(std::size_t const idx) {
+    if (idx < kSubBuckets) {
+      return idx + 1U;
+    }
+    auto const shift = idx / kSubBuckets - 1U;
+    auto const sub = idx % kSubBuckets;
+    return (kSubBuckets + sub + 1U) << shift;
+  }
+
+  void record(std::chrono::microseconds const d) {
+    auto const us = static_cast<std::uint64_t>(
+        std::max(d.count(), std::chrono::microseconds::rep{0}));
+    counts_[bucket_idx(us)].fetch_add(1U, std::memory_order_relaxed);
+    count_.fetch_add(1U, std::memory_order_relaxed);
+    sum_us_.fetch_add(us, std::memory_order_relaxed);
+  }
+
+  std::uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t sum_us() const {
+    return sum_us_.load(std::memory_order_relaxed);
+  }
+
+  // number of recorded values < limit_us (exact if limit_us is a bucket end)
+  std::uint64_t count_below(std::uint64_t const limit_us) const {
+    auto n = std::uint64_t{0U};
+    for (auto i = std::size_t{0U}; i != kBuckets && bucket_end(i) <= limit_us;
+         ++i) {
+      n += counts_[i].load(std::memory_order_relaxed);
+    }
+    return n;
+  }
+
+  // upper bound of the bucket containing the q-quantile (0 if empty)
+  std::uint64_t quantile_us(double const q) const {
+    auto const total = count();
+    if (total == 0U) {
+      return 0U;
+    }
+    auto const rank =
+        static_cast<std::uint64_t>(q * static_cast<double>(total));
+    auto n = std::uint64_t{0U};
+    for (auto i = std::size_t{0U}; i != kBuckets; ++i) {
+      n += counts_[i].load(std::memory_order_relaxed);
+      if (n > rank) {
+        return bucket_end(i);
+      }
+    }
+    return bucket_end(kBuckets - 1U);
+  }
+
+  std::array<std::atomic<std::uint64_t>, kBuckets> counts_{};
+  std::atomic<std::uint64_t> count_{0U};
+  std::atomic<std::uint64_t> sum_us_{0U};
+};
+
+}  // namespace motis::module
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+
+#include "motis/module/latency_histogram.h"
+#include "motis/module/op_scheduler.h"
+#include "motis/module/response_cache.h"
+
+namespace motis::module {
+
+struct op_counters {
+  void begin() { in_flight_.fetch_add(1, std::memory_order_relaxed); }
+
+  void end(std::chrono::microseconds const duration, bool const error) {
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    if (error) {
+      errors_.fetch_add(1U, std::memory_order_relaxed);
+    }
+    latency_.record(duration);
+  }
+
+  latency_histogram latency_;
+  std::atomic<std::int64_t> in_flight_{0};
+  std::atomic<std::uint64_t> errors_{0U};
+};
+
+// Per operation counters. Counters are created on first use, recording is
+// lock-free afterwards.
+struct op_metrics {
+  op_counters& get(std::string const& op_name);
+
+  void write_prometheus(std::ostream&) const;
+
+private:
+  std::shared_mutex mutable mutex_;
+  std::map<std::string, std::unique_ptr<op_counters>> ops_;
+};
+
+void write_prometheus(
+    std::ostream&,
+    std::array<op_scheduler::class_stats, kNumOpPriorities> const&);
+
+void write_prometheus(std::ostream&, response_cache::stats const&);
+
+}  // namespace motis::module
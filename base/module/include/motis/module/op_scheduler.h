@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace motis::module {
+
+enum class op_priority : std::uint8_t { INTERACTIVE, DEFAULT, BATCH };
+
+constexpr auto const kNumOpPriorities = 3U;
+
+char const* to_str(op_priority);
+
+struct op_options {
+  op_priority priority_{op_priority::DEFAULT};
+
+  // requests that waited longer than this before they could be started
+  // are rejected (0 = no limit)
+  std::chrono::milliseconds latency_budget_{0};
+
+  // successful responses of top-level requests are cached for this duration
+  // and identical concurrent requests are coalesced (0 = no caching), the
+  // cache is invalidated by /rt/graph_updated
+  std::chrono::seconds cache_ttl_{0};
+};
+
+constexpr auto const kInteractiveOp =
+    op_options{op_priority::INTERACTIVE, std::chrono::milliseconds{2000}};
+constexpr auto const kBatchOp = op_options{op_priority::BATCH};
+
+constexpr op_options with_cache_ttl(op_options options,
+                                    std::chrono::seconds const ttl) {
+  options.cache_ttl_ = ttl;
+  return options;
+}
+
+// Admission control for top-level requests.
+//
+// The available slots (= worker threads) are split between the priority
+// classes. Every class has its own queue and is served from its own slots
+// first. Idle slots can be stolen by other classes if their owner has
+// nothing queued. One INTERACTIVE slot is never lent, so cheap requests
+// always find capacity even if the other classes are overloaded. Requests are
+// rejected if the queue of their class is full or their latency budget
+// expired while waiting.
+struct op_scheduler {
+  using clock = std::chrono::steady_clock;
+
+  struct slot {
+    op_priority class_;
+    op_priority owner_;
+  };
+
+  using start_fn_t = std::function<void(slot)>;
+  using reject_fn_t = std::function<void()>;
+
+  struct class_stats {
+    std::size_t queue_depth_{};
+    std::size_t max_queue_depth_{};
+    std::size_t running_{};
+    std::uint64_t admitted_{};
+    std::uint64_t rejected_{};  // queue full
+    std::uint64_t expired_{};  // latency budget exceeded while queued
+    std::uint64_t stolen_{};  // started on a slot of another class
+    std::chrono::microseconds total_wait_{};
+    std::chrono::microseconds max_wait_{};
+  };
+
+  explicit op_scheduler(
+      unsigned slot_count = std::thread::hardware_concurrency());
+
+  void configure(unsigned slot_count);
+
+  // start is called as soon as a slot is available, finish has to be called
+  // with the given slot when the operation is done.
+  // returns false (without calling start or expire) if the queue is full.
+  bool submit(op_priority, std::chrono::milliseconds latency_budget,
+              start_fn_t start, reject_fn_t expire);
+
+  void finish(slot);
+
+  std::array<class_stats, kNumOpPriorities> stats() const;
+
+  unsigned slot_count(op_priority) const;
+  std::size_t max_queue_size(op_priority) const;
+
+  // disabled: the dispatcher starts requests without admission control
+  // (e.g. in batch mode, which limits concurrency itself)
+  void set_enabled(bool);
+  bool enabled() const;
+
+private:
+  struct pending {
+    start_fn_t start_;
+    reject_fn_t expire_;
+    clock::time_point enqueued_;
+    std::chrono::milliseconds latency_budget_;
+  };
+
+  using action_list = std::vector<std::function<void()>>;
+
+  bool find_slot(unsigned cls, unsigned& owner) const;
+  void schedule(action_list&);
+  static void run(action_list&);
+
+  std::mutex mutable mutex_;
+  std::array<std::deque<pending>, kNumOpPriorities> queues_;
+  std::array<unsigned, kNumOpPriorities> slots_{};
+  std::array<unsigned, kNumOpPriorities> reserved_{};  // never lent
+  std::array<unsigned, kNumOpPriorities> used_{};
+  std::array<std::size_t, kNumOpPriorities> max_queue_size_{};
+  std::array<class_stats, kNumOpPriorities> stats_{};
+  bool enabled_{true};
+};
+
+}  // namespace motis::module
@@ -9,6 +9,7 @@
 #include "motis/module/client.h"
 #include "motis/module/global_res_ids.h"
 #include "motis/module/message.h"
+#include "motis/module/op_scheduler.h"
 #include "motis/module/receiver.h"
 
 namespace motis::module {
@@ -19,17 +20,19 @@ using remote_op_fn_t = std::function<void(msg_ptr, callback)>;
 
 struct op {
   op(std::function<msg_ptr(msg_ptr const&)> fn,
-     std::vector<ctx::access_request> access)
-      : fn_{std::move(fn)}, access_{std::move(access)} {}
+     std::vector<ctx::access_request> access, op_options options = {})
+      : fn_{std::move(fn)}, access_{std::move(access)}, options_{options} {}
   op_fn_t fn_;
   ctx::accesses_t access_;
+  op_options options_;
 };
 
 constexpr auto const kScheduleReadAccess = ctx::access_request{
     to_res_id(global_res_id::SCHEDULE), ctx::access_t::READ};
 
 struct registry {
-  void register_op(std::string const& name, op_fn_t, ctx::accesses_t&&);
+  void register_op(std::string const& name, op_fn_t, ctx::accesses_t&&,
+                   op_options = {});
 
   void register_client_handler(std::string&& target,
                                std::function<void(client_hdl)>&&);
@@ -46,6 +49,10 @@ struct registry {
 
   std::optional<op> get_operation(std::string const& prefix);
 
+  // registered operation matching the prefix (end(operations_) if not found)
+  std::map<std::string, op>::const_iterator find_operation(
+      std::string const& prefix) const;
+
   void reset();
 
   std::map<std::string, op> operations_;
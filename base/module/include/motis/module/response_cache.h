@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include "motis/module/message.h"
+#include "motis/module/receiver.h"
+
+namespace motis::module {
+
+// Response cache with single-flight coalescing of identical requests.
+//
+// Requests are identified by their canonical JSON representation (without
+// the message id) and the cache generation. The generation is incremented
+// by invalidate() which drops all cached responses. Running requests of
+// older generations still answer their waiters but are not cached.
+//
+// Only top-level requests are cached: a nested request never waits for a
+// running request (its operation already holds a scheduler slot). Cached
+// responses (incl. keys) are limited to max_bytes, responses that do not
+// fit after expired entries have been evicted are not stored.
+struct response_cache {
+  using clock = std::chrono::steady_clock;
+
+  enum class lookup_result {
+    HIT,  // cb was called with the cached response
+    JOINED,  // cb is called when the identical running request finishes
+    MISS,  // caller has to execute the request and call complete()
+    BYPASS  // caller has to execute the request without caching
+  };
+
+  struct stats {
+    std::uint64_t hits_{}, joined_{}, misses_{}, stored_{}, invalidations_{};
+    std::size_t entries_{}, bytes_{};
+  };
+
+  explicit response_cache(std::size_t max_entries = 10'000U,
+                          std::size_t max_bytes = 256U * 1024U * 1024U)
+      : max_entries_{max_entries}, max_bytes_{max_bytes} {}
+
+  static std::string canonical_request(message const&);
+
+  // key: set to the key that has to be passed to complete() (MISS only)
+  lookup_result lookup(std::string const& request, callback const& cb,
+                       std::string& key);
+
+  // stores a successful response (if the generation is still current) and
+  // answers all joined requests
+  void complete(std::string const& key, std::chrono::seconds ttl,
+                msg_ptr const& res, std::error_code ec);
+
+  void invalidate();
+
+  // disabled: every lookup returns BYPASS (e.g. for benchmarks)
+  void set_enabled(bool);
+
+  stats get_stats() const;
+
+private:
+  struct entry {
+    bool running_{true};
+    std::uint64_t generation_{0U};
+    msg_ptr response_;
+    clock::time_point expires_;
+    std::vector<callback> waiters_;
+  };
+
+  void evict(clock::time_point now);
+  void erase(std::unordered_map<std::string, entry>::iterator);
+
+  std::mutex mutable mutex_;
+  std::unordered_map<std::string, entry> entries_;
+  std::uint64_t generation_{0U};
+  bool enabled_{true};
+  std::size_t max_entries_, max_bytes_, bytes_{0U};
+  stats stats_;
+};
+
+}  // namespace motis::module
@@ -1,6 +1,8 @@
 #include "motis/module/dispatcher.h"
 
+#include <chrono>
 #include <queue>
+#include <sstream>
 #include <string_view>
 
 #include "boost/asio/post.hpp"
@@ -66,6 +68,10 @@ bool dispatcher::connect_ok(std::string const& target) {
 std::vector<future> dispatcher::publish(msg_ptr const& msg,
                                         ctx_data const& data, ctx::op_id id) {
   id.name = msg->get()->destination()->target()->str();
+  if (id.name == "/rt/graph_updated") {
+    cache_.invalidate();
+  }
+
   auto it = registry_.topic_subscriptions_.find(id.name);
   if (it == end(registry_.topic_subscriptions_)) {
     return {};
@@ -102,11 +108,54 @@ future dispatcher::req(msg_ptr const& msg, ctx_data const& data,
   return f;
 }
 
-void dispatcher::dispatch(msg_ptr const& msg, callback const& cb, ctx::op_id id,
-                          ctx::op_type_t const op_type, ctx_data const* data) {
+void dispatcher::dispatch(msg_ptr const& msg, callback const& user_cb,
+                          ctx::op_id id, ctx::op_type_t const op_type,
+                          ctx_data const* data) {
   id.name = msg->get()->destination()->target()->str();
   if (id.name == "/api") {
-    return cb(api_desc(msg->id()), std::error_code{});
+    return user_cb(api_desc(msg->id()), std::error_code{});
+  }
+
+  auto const op_it = registry_.find_operation(id.name);
+  auto& counters =
+      metrics_.get(op_it != end(registry_.operations_) ? op_it->first
+                   : registry_.get_remote_op(id.name).has_value()
+                       ? "(remote)"
+                       : "(not found)");
+  counters.begin();
+  auto cb = callback{[&counters, user_cb,
+                            start = std::chrono::steady_clock::now()](
+                               msg_ptr res, std::error_code ec) {
+    counters.end(std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - start),
+                 ec || (res != nullptr &&
+                        res->get()->content_type() == MsgContent_MotisError));
+    user_cb(std::move(res), ec);
+  }};
+
+  auto access = ctx::accesses_t{};
+  auto options = op_options{};
+  if (op_it != end(registry_.operations_)) {
+    access = op_it->second.access_;
+    options = op_it->second.options_;
+  }
+
+  // nested requests are not cached: waiting for an identical running request
+  // could deadlock because their operation already holds a slot
+  if (options.cache_ttl_.count() != 0 && data == nullptr) {
+    auto key = std::string{};
+    switch (cache_.lookup(response_cache::canonical_request(*msg), cb, key)) {
+      case response_cache::lookup_result::HIT:
+      case response_cache::lookup_result::JOINED: return;
+      case response_cache::lookup_result::MISS:
+        cb = [this, key, ttl = options.cache_ttl_, inner = std::move(cb)](
+                 msg_ptr res, std::error_code ec) {
+          cache_.complete(key, ttl, res, ec);
+          inner(std::move(res), ec);
+        };
+        break;
+      case response_cache::lookup_result::BYPASS: break;
+    }
   }
 
   auto const run = [this, id, cb, msg]() {
@@ -135,15 +184,39 @@ void dispatcher::dispatch(msg_ptr const& msg, callback const& cb, ctx::op_id id,
 
   if (direct_mode_dispatcher_ != nullptr) {
     run();
-  } else {
-    auto access = ctx::accesses_t{};
-    if (auto const op = registry_.get_operation(id.name); op) {
-      access = op->access_;
-    }
+    return;
+  }
 
+  if (data != nullptr || !scheduler_.enabled()) {
+    // nested requests are part of an operation that already holds a slot:
+    // queueing them could deadlock
     enqueue(
-        data != nullptr ? ctx_data{*data} : ctx_data{this}, [run]() { run(); },
-        id, op_type, std::move(access));
+        ctx_data{*data}, [run]() { run(); }, id, op_type, std::move(access));
+    return;
+  }
+
+  auto const admitted = scheduler_.submit(
+      options.priority_, options.latency_budget_,
+      [this, run, id, op_type,
+       access = std::move(access)](op_scheduler::slot const s) mutable {
+        enqueue(
+            ctx_data{this},
+            [this, run, s]() {
+              try {
+                run();
+              } catch (...) {
+                scheduler_.finish(s);
+                throw;
+              }
+              scheduler_.finish(s);
+            },
+            id, op_type, std::move(access));
+      },
+      [cb]() { cb(nullptr, error::latency_budget_exceeded); });
+  if (!admitted) {
+    LOG(logging::warn) << "request rejected (" << to_str(options.priority_)
+                       << " queue full): " << id.name;
+    cb(nullptr, error::too_many_requests);
   }
 }
 
@@ -161,6 +234,14 @@ msg_ptr dispatcher::api_desc(int const id) const {
   return make_msg(fbb);
 }
 
+std::string dispatcher::prometheus_metrics() const {
+  std::stringstream ss;
+  metrics_.write_prometheus(ss);
+  write_prometheus(ss, scheduler_.stats());
+  write_prometheus(ss, cache_.get_stats());
+  return ss.str();
+}
+
 void dispatcher::handle_no_target(msg_ptr const& msg, callback const& cb) {
   if (queue_no_target_msgs_) {
     no_target_msg_queue_.emplace(msg, cb);
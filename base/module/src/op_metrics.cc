@@ -0,0 +1,201 @@
+#include "motis/module/op_metrics.h"
+
+#include <iomanip>
+#include <limits>
+#include <mutex>
+
+namespace motis::module {
+
+namespace {
+
+// approximate upper bounds of the exported histogram buckets in microseconds
+constexpr std::uint64_t const kExportedBucketsUs[] = {
+    1'000,     2'500,     5'000,     10'000,     25'000,     50'000,
+    100'000,   250'000,   500'000,   1'000'000,  2'500'000,  5'000'000,
+    10'000'000, 30'000'000, 60'000'000};
+
+// the exported bounds are the largest latency histogram bucket ends not
+// exceeding the approximate bounds, so every exported count is exact
+constexpr std::uint64_t exported_bucket_end(std::uint64_t const limit_us) {
+  auto end = latency_histogram::bucket_end(0U);
+  for (auto i = std::size_t{0U}; i != latency_histogram::kBuckets &&
+                                 latency_histogram::bucket_end(i) <= limit_us;
+       ++i) {
+    end = latency_histogram::bucket_end(i);
+  }
+  return end;
+}
+
+constexpr double const kExportedQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+struct label {
+  friend std::ostream& operator<<(std::ostream& out, label const& l) {
+    for (auto const c : l.value_) {
+      switch (c) {
+        case '\\': out << "\\\\"; break;
+        case '"': out << "\\\""; break;
+        case '\n': out << "\\n"; break;
+        default: out << c;
+      }
+    }
+    return out;
+  }
+
+  std::string const& value_;
+};
+
+inline double to_seconds(std::uint64_t const us) {
+  return static_cast<double>(us) / 1'000'000.0;
+}
+
+// exact decimal representation of a duration in seconds
+struct exact_seconds {
+  friend std::ostream& operator<<(std::ostream& out, exact_seconds const& s) {
+    out << s.us_ / 1'000'000U;
+    auto fraction = s.us_ % 1'000'000U;
+    if (fraction != 0U) {
+      auto digits = 6;
+      while (fraction % 10U == 0U) {
+        fraction /= 10U;
+        --digits;
+      }
+      out << '.' << std::setw(digits) << std::setfill('0') << fraction
+          << std::setfill(' ');
+    }
+    return out;
+  }
+
+  std::uint64_t us_;
+};
+
+}  // namespace
+
+op_counters& op_metrics::get(std::string const& op_name) {
+  {
+    std::shared_lock const lock{mutex_};
+    if (auto const it = ops_.find(op_name); it != end(ops_)) {
+      return *it->second;
+    }
+  }
+  std::unique_lock const lock{mutex_};
+  auto& counters = ops_[op_name];
+  if (!counters) {
+    counters = std::make_unique<op_counters>();
+  }
+  return *counters;
+}
+
+void op_metrics::write_prometheus(std::ostream& out) const {
+  std::shared_lock const lock{mutex_};
+
+  out << "# HELP motis_op_latency_seconds Operation latency (including "
+         "queueing).\n"
+      << "# TYPE motis_op_latency_seconds histogram\n";
+  for (auto const& [name, c] : ops_) {
+    auto const& h = c->latency_;
+    auto const total = h.count_below(std::numeric_limits<std::uint64_t>::max());
+    for (auto const limit : kExportedBucketsUs) {
+      // values are whole microseconds: < end is the same as <= end - 1
+      auto const end = exported_bucket_end(limit);
+      out << "motis_op_latency_seconds_bucket{op=\"" << label{name}
+          << "\",le=\"" << exact_seconds{end - 1U} << "\"} "
+          << h.count_below(end) << "\n";
+    }
+    out << "motis_op_latency_seconds_bucket{op=\"" << label{name}
+        << "\",le=\"+Inf\"} " << total << "\n"
+        << "motis_op_latency_seconds_sum{op=\"" << label{name} << "\"} "
+        << to_seconds(h.sum_us()) << "\n"
+        << "motis_op_latency_seconds_count{op=\"" << label{name} << "\"} "
+        << total << "\n";
+  }
+
+  out << "# HELP motis_op_latency_quantile_seconds Operation latency "
+         "quantiles since start.\n"
+      << "# TYPE motis_op_latency_quantile_seconds gauge\n";
+  for (auto const& [name, c] : ops_) {
+    for (auto const q : kExportedQuantiles) {
+      out << "motis_op_latency_quantile_seconds{op=\"" << label{name}
+          << "\",quantile=\"" << q << "\"} "
+          << to_seconds(c->latency_.quantile_us(q)) << "\n";
+    }
+  }
+
+  out << "# HELP motis_op_errors_total Failed operation calls.\n"
+      << "# TYPE motis_op_errors_total counter\n";
+  for (auto const& [name, c] : ops_) {
+    out << "motis_op_errors_total{op=\"" << label{name} << "\"} "
+        << c->errors_.load(std::memory_order_relaxed) << "\n";
+  }
+
+  out << "# HELP motis_op_in_flight Operation calls currently in progress.\n"
+      << "# TYPE motis_op_in_flight gauge\n";
+  for (auto const& [name, c] : ops_) {
+    out << "motis_op_in_flight{op=\"" << label{name} << "\"} "
+        << c->in_flight_.load(std::memory_order_relaxed) << "\n";
+  }
+}
+
+void write_prometheus(
+    std::ostream& out,
+    std::array<op_scheduler::class_stats, kNumOpPriorities> const& stats) {
+  auto const write = [&](char const* metric, char const* type,
+                         char const* help, auto&& get) {
+    out << "# HELP " << metric << " " << help << "\n"
+        << "# TYPE " << metric << " " << type << "\n";
+    for (auto cls = 0U; cls != kNumOpPriorities; ++cls) {
+      out << metric << "{class=\"" << to_str(static_cast<op_priority>(cls))
+          << "\"} " << get(stats[cls]) << "\n";
+    }
+  };
+
+  using stats_t = op_scheduler::class_stats;
+  write("motis_scheduler_queue_depth", "gauge", "Queued requests.",
+        [](stats_t const& s) { return s.queue_depth_; });
+  write("motis_scheduler_running", "gauge", "Running requests.",
+        [](stats_t const& s) { return s.running_; });
+  write("motis_scheduler_admitted_total", "counter", "Started requests.",
+        [](stats_t const& s) { return s.admitted_; });
+  write("motis_scheduler_rejected_total", "counter",
+        "Requests rejected because the queue was full.",
+        [](stats_t const& s) { return s.rejected_; });
+  write("motis_scheduler_expired_total", "counter",
+        "Requests rejected because their latency budget expired.",
+        [](stats_t const& s) { return s.expired_; });
+  write("motis_scheduler_stolen_total", "counter",
+        "Requests started on a slot of another class.",
+        [](stats_t const& s) { return s.stolen_; });
+  write("motis_scheduler_wait_seconds_total", "counter",
+        "Total time started requests spent in the queue.",
+        [](stats_t const& s) {
+          return to_seconds(static_cast<std::uint64_t>(s.total_wait_.count()));
+        });
+  write("motis_scheduler_max_wait_seconds", "gauge",
+        "Longest time a started request spent in the queue.",
+        [](stats_t const& s) {
+          return to_seconds(static_cast<std::uint64_t>(s.max_wait_.count()));
+        });
+}
+
+void write_prometheus(std::ostream& out, response_cache::stats const& s) {
+  auto const write = [&](char const* metric, char const* type,
+                         char const* help, auto const value) {
+    out << "# HELP " << metric << " " << help << "\n"
+        << "# TYPE " << metric << " " << type << "\n"
+        << metric << " " << value << "\n";
+  };
+  write("motis_cache_hits_total", "counter", "Responses served from the cache.",
+        s.hits_);
+  write("motis_cache_joined_total", "counter",
+        "Requests coalesced with an identical running request.", s.joined_);
+  write("motis_cache_misses_total", "counter",
+        "Cacheable requests that had to be executed.", s.misses_);
+  write("motis_cache_stored_total", "counter", "Responses stored.", s.stored_);
+  write("motis_cache_invalidations_total", "counter",
+        "Cache invalidations (real-time updates).", s.invalidations_);
+  write("motis_cache_entries", "gauge", "Cached and running entries.",
+        s.entries_);
+  write("motis_cache_bytes", "gauge", "Size of the cached responses.",
+        s.bytes_);
+}
+
+}  // namespace motis::module
@@ -0,0 +1,184 @@
+#include "motis/module/op_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "utl/verify.h"
+
+namespace motis::module {
+
+char const* to_str(op_priority const p) {
+  switch (p) {
+    case op_priority::INTERACTIVE: return "interactive";
+    case op_priority::DEFAULT: return "default";
+    case op_priority::BATCH: return "batch";
+  }
+  return "unknown";
+}
+
+namespace {
+
+constexpr unsigned idx(op_priority const p) { return static_cast<unsigned>(p); }
+
+}  // namespace
+
+op_scheduler::op_scheduler(unsigned const slot_count) {
+  configure(slot_count);
+}
+
+void op_scheduler::configure(unsigned slot_count) {
+  // 1/4 interactive, 1/4 batch, rest default (at least one slot per class)
+  slot_count = std::max(slot_count, 1U);
+  auto const interactive = std::max(slot_count / 4U, 1U);
+  auto const batch = std::max(slot_count / 4U, 1U);
+  auto const def =
+      std::max(slot_count - std::min(slot_count, interactive + batch), 1U);
+
+  std::lock_guard const lock{mutex_};
+  slots_[idx(op_priority::INTERACTIVE)] = interactive;
+  slots_[idx(op_priority::DEFAULT)] = def;
+  slots_[idx(op_priority::BATCH)] = batch;
+  reserved_[idx(op_priority::INTERACTIVE)] = 1U;
+  max_queue_size_[idx(op_priority::INTERACTIVE)] = 64U * slot_count;
+  max_queue_size_[idx(op_priority::DEFAULT)] = 32U * slot_count;
+  max_queue_size_[idx(op_priority::BATCH)] = 8U * slot_count;
+}
+
+bool op_scheduler::submit(op_priority const p,
+                          std::chrono::milliseconds const latency_budget,
+                          start_fn_t start, reject_fn_t expire) {
+  auto actions = action_list{};
+  {
+    std::lock_guard const lock{mutex_};
+    auto const cls = idx(p);
+    auto& queue = queues_[cls];
+    if (queue.size() >= max_queue_size_[cls]) {
+      ++stats_[cls].rejected_;
+      return false;
+    }
+    queue.emplace_back(pending{std::move(start), std::move(expire),
+                               clock::now(), latency_budget});
+    stats_[cls].max_queue_depth_ =
+        std::max(stats_[cls].max_queue_depth_, queue.size());
+    schedule(actions);
+  }
+  run(actions);
+  return true;
+}
+
+void op_scheduler::finish(slot const s) {
+  auto actions = action_list{};
+  {
+    std::lock_guard const lock{mutex_};
+    auto const owner = idx(s.owner_);
+    auto const cls = idx(s.class_);
+    utl::verify(used_[owner] != 0U && stats_[cls].running_ != 0U,
+                "op_scheduler::finish: slot not in use");
+    --used_[owner];
+    --stats_[cls].running_;
+    schedule(actions);
+  }
+  run(actions);
+}
+
+std::array<op_scheduler::class_stats, kNumOpPriorities> op_scheduler::stats()
+    const {
+  std::lock_guard const lock{mutex_};
+  auto stats = stats_;
+  for (auto cls = 0U; cls != kNumOpPriorities; ++cls) {
+    stats[cls].queue_depth_ = queues_[cls].size();
+  }
+  return stats;
+}
+
+unsigned op_scheduler::slot_count(op_priority const p) const {
+  std::lock_guard const lock{mutex_};
+  return slots_[idx(p)];
+}
+
+std::size_t op_scheduler::max_queue_size(op_priority const p) const {
+  std::lock_guard const lock{mutex_};
+  return max_queue_size_[idx(p)];
+}
+
+void op_scheduler::set_enabled(bool const enabled) {
+  std::lock_guard const lock{mutex_};
+  enabled_ = enabled;
+}
+
+bool op_scheduler::enabled() const {
+  std::lock_guard const lock{mutex_};
+  return enabled_;
+}
+
+bool op_scheduler::find_slot(unsigned const cls, unsigned& owner) const {
+  if (used_[cls] < slots_[cls]) {
+    owner = cls;
+    return true;
+  }
+
+  // steal from the least important idle class first
+  for (auto victim = kNumOpPriorities; victim != 0U; --victim) {
+    auto const v = victim - 1U;
+    if (v != cls && used_[v] + reserved_[v] < slots_[v] &&
+        queues_[v].empty()) {
+      owner = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+void op_scheduler::schedule(action_list& actions) {
+  auto const now = clock::now();
+  auto started = true;
+  while (started) {
+    started = false;
+    for (auto cls = 0U; cls != kNumOpPriorities && !started; ++cls) {
+      auto& queue = queues_[cls];
+      auto& stats = stats_[cls];
+
+      while (!queue.empty() &&
+             queue.front().latency_budget_.count() != 0 &&
+             now - queue.front().enqueued_ > queue.front().latency_budget_) {
+        ++stats.expired_;
+        actions.emplace_back(std::move(queue.front().expire_));
+        queue.pop_front();
+      }
+
+      auto owner = 0U;
+      if (queue.empty() || !find_slot(cls, owner)) {
+        continue;
+      }
+
+      auto p = std::move(queue.front());
+      queue.pop_front();
+
+      auto const wait =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              now - p.enqueued_);
+      ++used_[owner];
+      ++stats.running_;
+      ++stats.admitted_;
+      stats.total_wait_ += wait;
+      stats.max_wait_ = std::max(stats.max_wait_, wait);
+      if (owner != cls) {
+        ++stats.stolen_;
+      }
+
+      actions.emplace_back(
+          [start = std::move(p.start_),
+           s = slot{static_cast<op_priority>(cls),
+                    static_cast<op_priority>(owner)}]() { start(s); });
+      started = true;
+    }
+  }
+}
+
+void op_scheduler::run(action_list& actions) {
+  for (auto& action : actions) {
+    action();
+  }
+}
+
+}  // namespace motis::module
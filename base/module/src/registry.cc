@@ -12,11 +12,14 @@
 namespace motis::module {
 
 void registry::register_op(std::string const& name, op_fn_t fn,
-                           ctx::accesses_t&& access) {
+                           ctx::accesses_t&& access,
+                           op_options const options) {
   auto const call = [fn_rec = std::move(fn),
                      name](msg_ptr const& m) -> msg_ptr { return fn_rec(m); };
   auto const inserted =
-      operations_.emplace(name, op{std::move(call), std::move(access)}).second;
+      operations_
+          .emplace(name, op{std::move(call), std::move(access), options})
+          .second;
   utl::verify(inserted, "register_op: target {} already registered", name);
 }
 
@@ -79,12 +82,21 @@ std::optional<remote_op_fn_t> registry::get_remote_op(
 }
 
 std::optional<op> registry::get_operation(std::string const& prefix) {
+  if (auto const it = find_operation(prefix); it != end(operations_)) {
+    return it->second;
+  } else {
+    return std::nullopt;
+  }
+}
+
+std::map<std::string, op>::const_iterator registry::find_operation(
+    std::string const& prefix) const {
   if (auto const it = operations_.upper_bound(prefix);
       it != begin(operations_) &&
       boost::algorithm::starts_with(prefix, std::next(it, -1)->first)) {
-    return std::next(it, -1)->second;
+    return std::next(it, -1);
   } else {
-    return std::nullopt;
+    return end(operations_);
   }
 }
 
@@ -0,0 +1,153 @@
+#include "motis/module/response_cache.h"
+
+#include <utility>
+
+namespace motis::module {
+
+namespace {
+
+msg_ptr copy_msg(msg_ptr const& m) {
+  // responses are mutated by the receivers (message id)
+  return m == nullptr ? nullptr
+                      : std::make_shared<message>(m->size(), m->data());
+}
+
+bool is_error(msg_ptr const& res, std::error_code const ec) {
+  return ec || (res != nullptr &&
+                res->get()->content_type() == MsgContent_MotisError);
+}
+
+}  // namespace
+
+std::string response_cache::canonical_request(message const& request) {
+  auto copy = message{request.size(), request.data()};
+  copy.get()->mutate_id(0);
+  return copy.to_json(json_format::SINGLE_LINE);
+}
+
+response_cache::lookup_result response_cache::lookup(
+    std::string const& request, callback const& cb, std::string& key) {
+  auto const now = clock::now();
+  msg_ptr cached;
+  {
+    std::lock_guard const lock{mutex_};
+    if (!enabled_) {
+      return lookup_result::BYPASS;
+    }
+
+    key = std::to_string(generation_) + " " + request;
+    if (auto const it = entries_.find(key); it != end(entries_)) {
+      auto& e = it->second;
+      if (e.running_) {
+        e.waiters_.emplace_back(cb);
+        ++stats_.joined_;
+        return lookup_result::JOINED;
+      } else if (now < e.expires_) {
+        cached = e.response_;
+        ++stats_.hits_;
+      } else {
+        erase(it);
+      }
+    }
+
+    if (cached == nullptr) {
+      if (entries_.size() >= max_entries_) {
+        evict(now);
+        if (entries_.size() >= max_entries_) {
+          return lookup_result::BYPASS;
+        }
+      }
+
+      auto& e = entries_[key];
+      e.generation_ = generation_;
+      ++stats_.misses_;
+      return lookup_result::MISS;
+    }
+  }
+
+  cb(copy_msg(cached), std::error_code{});
+  return lookup_result::HIT;
+}
+
+void response_cache::complete(std::string const& key,
+                              std::chrono::seconds const ttl,
+                              msg_ptr const& res, std::error_code const ec) {
+  auto waiters = std::vector<callback>{};
+  {
+    std::lock_guard const lock{mutex_};
+    auto const it = entries_.find(key);
+    if (it == end(entries_)) {
+      return;
+    }
+
+    auto& e = it->second;
+    waiters = std::move(e.waiters_);
+    auto store = res != nullptr && !is_error(res, ec) &&
+                 e.generation_ == generation_ && ttl.count() != 0;
+    auto const size = store ? key.size() + res->size() : 0U;
+    if (store && bytes_ + size > max_bytes_) {
+      evict(clock::now());
+      store = bytes_ + size <= max_bytes_;
+    }
+
+    if (store) {
+      bytes_ += size;
+      e.running_ = false;
+      e.response_ = copy_msg(res);
+      e.expires_ = clock::now() + ttl;
+      ++stats_.stored_;
+    } else {
+      entries_.erase(it);  // running: no bytes accounted
+    }
+  }
+
+  for (auto const& cb : waiters) {
+    cb(copy_msg(res), ec);
+  }
+}
+
+void response_cache::invalidate() {
+  std::lock_guard const lock{mutex_};
+  ++generation_;
+  ++stats_.invalidations_;
+  for (auto it = begin(entries_); it != end(entries_);) {
+    if (it->second.running_) {
+      ++it;
+    } else {
+      erase(it++);
+    }
+  }
+}
+
+void response_cache::set_enabled(bool const enabled) {
+  std::lock_guard const lock{mutex_};
+  enabled_ = enabled;
+}
+
+response_cache::stats response_cache::get_stats() const {
+  std::lock_guard const lock{mutex_};
+  auto s = stats_;
+  s.entries_ = entries_.size();
+  s.bytes_ = bytes_;
+  return s;
+}
+
+void response_cache::evict(clock::time_point const now) {
+  for (auto it = begin(entries_); it != end(entries_);) {
+    if (!it->second.running_ && it->second.expires_ <= now) {
+      erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void response_cache::erase(
+    std::unordered_map<std::string, entry>::iterator const it) {
+  if (!it->second.running_) {
+    bytes_ -= it->first.size() + it->second.response_->size();
+  }
+  entries_.erase(it);
+}
+
+}  // namespace motis::module
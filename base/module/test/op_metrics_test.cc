@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "motis/module/op_metrics.h"
+
+using namespace motis::module;
+
+TEST(module_latency_histogram, buckets) {
+  using h = latency_histogram;
+  for (auto us = std::uint64_t{0U}; us != 100'000U; ++us) {
+    auto const idx = h::bucket_idx(us);
+    ASSERT_LT(us, h::bucket_end(idx));
+    if (idx != 0U) {
+      ASSERT_GE(us, h::bucket_end(idx - 1U));
+    }
+  }
+  EXPECT_EQ(h::kBuckets - 1U, h::bucket_idx(1ULL << 40U));
+}
+
+TEST(module_latency_histogram, quantiles) {
+  auto h = latency_histogram{};
+  EXPECT_EQ(0U, h.quantile_us(0.5));
+
+  for (auto i = 1; i <= 1000; ++i) {
+    h.record(std::chrono::microseconds{i * 100});
+  }
+  EXPECT_EQ(1000U, h.count());
+  EXPECT_EQ(50'050'000U, h.sum_us());
+
+  auto const p50 = static_cast<double>(h.quantile_us(0.5));
+  auto const p99 = static_cast<double>(h.quantile_us(0.99));
+  EXPECT_NEAR(50'000.0, p50, 50'000.0 / 8.0);
+  EXPECT_NEAR(99'000.0, p99, 99'000.0 / 8.0);
+  EXPECT_EQ(0U, h.count_below(100U));
+  EXPECT_EQ(1000U, h.count_below(1'000'000U));
+}
+
+TEST(module_op_metrics, prometheus) {
+  auto m = op_metrics{};
+  auto& routing = m.get("/routing");
+  EXPECT_EQ(&routing, &m.get("/routing"));
+
+  routing.begin();
+  routing.end(std::chrono::milliseconds{3}, false);
+  routing.begin();
+  routing.end(std::chrono::seconds{2}, true);
+  m.get("/lookup/geo_station").begin();
+
+  std::stringstream ss;
+  m.write_prometheus(ss);
+  auto const out = ss.str();
+
+  // le = last histogram bucket end <= 2.5ms / 5ms (3ms is in [2816, 3072))
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_latency_seconds_bucket{op=\"/routing\","
+                     "le=\"0.002303\"} 0\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_latency_seconds_bucket{op=\"/routing\","
+                     "le=\"0.004607\"} 1\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_latency_seconds_bucket{op=\"/routing\","
+                     "le=\"0.983039\"} 1\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_latency_seconds_bucket{op=\"/routing\","
+                     "le=\"2.359295\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_latency_seconds_bucket{op=\"/routing\","
+                     "le=\"+Inf\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_latency_seconds_count{op=\"/routing\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_errors_total{op=\"/routing\"} 1\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_in_flight{op=\"/lookup/geo_station\"} 1\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_op_in_flight{op=\"/routing\"} 0\n"));
+}
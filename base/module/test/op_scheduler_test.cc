@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "motis/module/op_scheduler.h"
+
+using namespace motis::module;
+
+namespace {
+
+struct recorder {
+  op_scheduler::start_fn_t start(int const id) {
+    return [this, id](op_scheduler::slot const s) {
+      started_.emplace_back(id);
+      slots_.emplace_back(s);
+    };
+  }
+
+  op_scheduler::reject_fn_t expire(int const id) {
+    return [this, id]() { expired_.emplace_back(id); };
+  }
+
+  std::vector<int> started_, expired_;
+  std::vector<op_scheduler::slot> slots_;
+};
+
+}  // namespace
+
+TEST(module_op_scheduler, interactive_slots_are_reserved) {
+  auto sched = op_scheduler{4U};
+  ASSERT_EQ(1U, sched.slot_count(op_priority::INTERACTIVE));
+  ASSERT_EQ(2U, sched.slot_count(op_priority::DEFAULT));
+  ASSERT_EQ(1U, sched.slot_count(op_priority::BATCH));
+
+  auto r = recorder{};
+  auto const no_budget = std::chrono::milliseconds{0};
+  for (auto i = 0; i != 6; ++i) {
+    EXPECT_TRUE(sched.submit(op_priority::BATCH, no_budget, r.start(i),
+                             r.expire(i)));
+  }
+
+  // batch uses its own slot + the idle default slots, never the reserved
+  // interactive slot
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), r.started_);
+  auto stats = sched.stats();
+  EXPECT_EQ(3U, stats[2].queue_depth_);
+  EXPECT_EQ(3U, stats[2].running_);
+  EXPECT_EQ(2U, stats[2].stolen_);
+
+  EXPECT_TRUE(sched.submit(op_priority::INTERACTIVE, no_budget, r.start(10),
+                           r.expire(10)));
+  EXPECT_EQ(10, r.started_.back());
+  EXPECT_EQ(op_priority::INTERACTIVE, r.slots_.back().owner_);
+
+  // a default request queued behind the batch requests gets the first
+  // default slot that is freed
+  EXPECT_TRUE(sched.submit(op_priority::DEFAULT, no_budget, r.start(20),
+                           r.expire(20)));
+  EXPECT_EQ(10, r.started_.back());
+  sched.finish(r.slots_[1]);
+  EXPECT_EQ(20, r.started_.back());
+  EXPECT_EQ(op_priority::DEFAULT, r.slots_.back().owner_);
+
+  // freed batch slot: next batch request
+  sched.finish(r.slots_[0]);
+  EXPECT_EQ(3, r.started_.back());
+
+  stats = sched.stats();
+  EXPECT_EQ(2U, stats[2].queue_depth_);
+  EXPECT_EQ(1U, stats[0].admitted_);
+  EXPECT_EQ(1U, stats[1].admitted_);
+  EXPECT_EQ(4U, stats[2].admitted_);
+  EXPECT_TRUE(r.expired_.empty());
+}
+
+TEST(module_op_scheduler, idle_interactive_slots_are_lent) {
+  auto sched = op_scheduler{8U};
+  ASSERT_EQ(2U, sched.slot_count(op_priority::INTERACTIVE));
+  ASSERT_EQ(4U, sched.slot_count(op_priority::DEFAULT));
+  ASSERT_EQ(2U, sched.slot_count(op_priority::BATCH));
+
+  auto r = recorder{};
+  auto const no_budget = std::chrono::milliseconds{0};
+  for (auto i = 0; i != 10; ++i) {
+    EXPECT_TRUE(sched.submit(op_priority::DEFAULT, no_budget, r.start(i),
+                             r.expire(i)));
+  }
+
+  // default uses its own slots, the batch slots and all but one of the
+  // interactive slots
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6}), r.started_);
+  EXPECT_EQ(op_priority::INTERACTIVE, r.slots_.back().owner_);
+  EXPECT_EQ(3U, sched.stats()[1].stolen_);
+
+  EXPECT_TRUE(sched.submit(op_priority::INTERACTIVE, no_budget, r.start(10),
+                           r.expire(10)));
+  EXPECT_EQ(10, r.started_.back());
+  EXPECT_EQ(op_priority::INTERACTIVE, r.slots_.back().owner_);
+}
+
+TEST(module_op_scheduler, admission_control) {
+  auto sched = op_scheduler{1U};
+  auto r = recorder{};
+  auto const no_budget = std::chrono::milliseconds{0};
+
+  // one slot for every class
+  EXPECT_TRUE(sched.submit(op_priority::BATCH, no_budget, r.start(0),
+                           r.expire(0)));
+  EXPECT_TRUE(sched.submit(op_priority::BATCH, no_budget, r.start(1),
+                           r.expire(1)));
+  EXPECT_EQ((std::vector<int>{0, 1}), r.started_);
+
+  auto const max_queue_size = sched.max_queue_size(op_priority::BATCH);
+  for (auto i = 0U; i != max_queue_size; ++i) {
+    EXPECT_TRUE(sched.submit(op_priority::BATCH, no_budget, r.start(100),
+                             r.expire(100)));
+  }
+  EXPECT_FALSE(sched.submit(op_priority::BATCH, no_budget, r.start(200),
+                            r.expire(200)));
+  EXPECT_EQ(1U, sched.stats()[2].rejected_);
+}
+
+TEST(module_op_scheduler, latency_budget) {
+  auto sched = op_scheduler{1U};
+  auto r = recorder{};
+
+  // own slot + stolen default and batch slots
+  for (auto i = 0; i != 4; ++i) {
+    EXPECT_TRUE(sched.submit(op_priority::INTERACTIVE,
+                             std::chrono::milliseconds{1}, r.start(i),
+                             r.expire(i)));
+  }
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), r.started_);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  sched.finish(r.slots_[0]);
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), r.started_);
+  EXPECT_EQ((std::vector<int>{3}), r.expired_);
+  EXPECT_EQ(1U, sched.stats()[0].expired_);
+}
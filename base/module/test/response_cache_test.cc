@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "motis/module/message.h"
+#include "motis/module/response_cache.h"
+
+using namespace motis::module;
+
+using lookup_result = response_cache::lookup_result;
+
+namespace {
+
+constexpr auto const kTtl = std::chrono::seconds{60};
+
+struct recorder {
+  callback cb() {
+    return [this](msg_ptr res, std::error_code ec) {
+      responses_.emplace_back(std::move(res));
+      errors_.emplace_back(ec);
+    };
+  }
+
+  std::vector<msg_ptr> responses_;
+  std::vector<std::error_code> errors_;
+};
+
+}  // namespace
+
+TEST(module_response_cache, canonical_request_ignores_id) {
+  EXPECT_EQ(response_cache::canonical_request(*make_no_msg("/routing", 1)),
+            response_cache::canonical_request(*make_no_msg("/routing", 2)));
+  EXPECT_NE(response_cache::canonical_request(*make_no_msg("/routing", 1)),
+            response_cache::canonical_request(*make_no_msg("/intermodal", 1)));
+}
+
+TEST(module_response_cache, single_flight) {
+  auto cache = response_cache{};
+  auto const req = response_cache::canonical_request(*make_no_msg("/routing"));
+  auto r = recorder{};
+
+  auto key = std::string{};
+  ASSERT_EQ(lookup_result::MISS, cache.lookup(req, r.cb(), key));
+
+  auto joined_key = std::string{};
+  EXPECT_EQ(lookup_result::JOINED,
+            cache.lookup(req, r.cb(), joined_key));
+  EXPECT_TRUE(r.responses_.empty());
+
+  auto const res = make_success_msg();
+  cache.complete(key, kTtl, res, std::error_code{});
+  ASSERT_EQ(1U, r.responses_.size());
+  EXPECT_NE(res, r.responses_[0]);
+  EXPECT_EQ(res->to_string(), r.responses_[0]->to_string());
+
+  EXPECT_EQ(lookup_result::HIT,
+            cache.lookup(req, r.cb(), joined_key));
+  ASSERT_EQ(2U, r.responses_.size());
+  EXPECT_EQ(res->to_string(), r.responses_[1]->to_string());
+
+  auto const stats = cache.get_stats();
+  EXPECT_EQ(1U, stats.hits_);
+  EXPECT_EQ(1U, stats.joined_);
+  EXPECT_EQ(1U, stats.misses_);
+  EXPECT_EQ(1U, stats.stored_);
+}
+
+TEST(module_response_cache, invalidate_and_errors) {
+  auto cache = response_cache{};
+  auto const req = response_cache::canonical_request(*make_no_msg("/routing"));
+  auto r = recorder{};
+
+  auto key = std::string{};
+  ASSERT_EQ(lookup_result::MISS, cache.lookup(req, r.cb(), key));
+  cache.complete(key, kTtl, make_success_msg(), std::error_code{});
+
+  cache.invalidate();
+  ASSERT_EQ(lookup_result::MISS, cache.lookup(req, r.cb(), key));
+
+  // errors are passed to the joined requests but not cached
+  auto const ec = make_error_code(error::unknown_error);
+  auto miss_key = std::string{};
+  EXPECT_EQ(lookup_result::JOINED,
+            cache.lookup(req, r.cb(), miss_key));
+  EXPECT_EQ(lookup_result::JOINED,
+            cache.lookup(req, r.cb(), miss_key));
+  cache.complete(key, kTtl, nullptr, ec);
+  ASSERT_EQ(2U, r.errors_.size());
+  EXPECT_EQ(ec, r.errors_[0]);
+  EXPECT_EQ(ec, r.errors_[1]);
+  EXPECT_EQ(lookup_result::MISS,
+            cache.lookup(req, r.cb(), miss_key));
+}
+
+TEST(module_response_cache, byte_budget) {
+  auto const res = make_success_msg();
+  auto const req_a = response_cache::canonical_request(*make_no_msg("/a"));
+  auto const req_b = response_cache::canonical_request(*make_no_msg("/b"));
+  auto const entry_size = std::string{"0 "}.size() + req_a.size() + res->size();
+
+  // room for one response
+  auto cache = response_cache{10U, entry_size + entry_size / 2U};
+  auto r = recorder{};
+
+  auto key = std::string{};
+  ASSERT_EQ(lookup_result::MISS, cache.lookup(req_a, r.cb(), key));
+  cache.complete(key, kTtl, res, std::error_code{});
+  EXPECT_EQ(entry_size, cache.get_stats().bytes_);
+
+  // does not fit: answered but not stored
+  ASSERT_EQ(lookup_result::MISS, cache.lookup(req_b, r.cb(), key));
+  cache.complete(key, kTtl, res, std::error_code{});
+  EXPECT_EQ(1U, cache.get_stats().stored_);
+  EXPECT_EQ(1U, cache.get_stats().entries_);
+  EXPECT_EQ(lookup_result::HIT, cache.lookup(req_a, r.cb(), key));
+  EXPECT_EQ(lookup_result::MISS, cache.lookup(req_b, r.cb(), key));
+
+  // expired entries are evicted to make room
+  auto expiring = response_cache{10U, entry_size + entry_size / 2U};
+  ASSERT_EQ(lookup_result::MISS, expiring.lookup(req_a, r.cb(), key));
+  expiring.complete(key, -kTtl, res, std::error_code{});
+  ASSERT_EQ(lookup_result::MISS, expiring.lookup(req_b, r.cb(), key));
+  expiring.complete(key, kTtl, res, std::error_code{});
+  EXPECT_EQ(entry_size, expiring.get_stats().bytes_);
+  EXPECT_EQ(lookup_result::HIT, expiring.lookup(req_b, r.cb(), key));
+
+  expiring.invalidate();
+  EXPECT_EQ(0U, expiring.get_stats().bytes_);
+}
+
+TEST(module_response_cache, disabled) {
+  auto cache = response_cache{};
+  cache.set_enabled(false);
+  auto const req = response_cache::canonical_request(*make_no_msg("/routing"));
+  auto r = recorder{};
+
+  auto key = std::string{};
+  EXPECT_EQ(lookup_result::BYPASS, cache.lookup(req, r.cb(), key));
+  EXPECT_EQ(lookup_result::BYPASS, cache.lookup(req, r.cb(), key));
+  EXPECT_TRUE(r.responses_.empty());
+  EXPECT_EQ(0U, cache.get_stats().entries_);
+}
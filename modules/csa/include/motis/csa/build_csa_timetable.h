@@ -1,13 +1,55 @@
 #pragma once
 
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "motis/core/schedule/schedule.h"
 
 #include "motis/csa/csa_timetable.h"
 
 namespace motis::csa {
 
+// fwd_connections_: ascending departure (trip order for equal departures)
+inline bool fwd_connection_order(csa_connection const& a,
+                                 csa_connection const& b) {
+  return std::tie(a.departure_, a.trip_, a.trip_con_idx_) <
+         std::tie(b.departure_, b.trip_, b.trip_con_idx_);
+}
+
+// bwd_connections_: descending arrival, then reverse fwd_connections_ order
+inline bool bwd_connection_order(csa_connection const& a,
+                                 csa_connection const& b) {
+  return std::tie(b.arrival_, b.departure_, b.trip_, b.trip_con_idx_) <
+         std::tie(a.arrival_, a.departure_, a.trip_, a.trip_con_idx_);
+}
+
 std::unique_ptr<csa_timetable> build_csa_timetable(
     schedule const&, bool bridge_zero_duration_connections,
     bool add_footpath_connections);
 
+// Bucket starts of the connections in [from, to) (absolute indices).
+// The connection at from has to start a bucket.
+std::vector<uint32_t> get_bucket_starts(std::vector<csa_connection> const&,
+                                        std::size_t from, std::size_t to,
+                                        search_dir, bool bridged);
+
+// Recomputes the bucket starts after the connections in [from, to) changed
+// (only for timetables without bridged connections).
+void update_bucket_starts(std::vector<uint32_t>& bucket_starts,
+                          std::vector<csa_connection> const&, std::size_t from,
+                          std::size_t to, search_dir);
+
+// Recomputes fwd_partitions_ and bwd_partitions_ (required after the
+// connections were built or moved).
+void build_partitions(csa_timetable&);
+
+// Recomputes the partitions of one direction after the connections in the
+// given index ranges [from, to) changed or moved (only for timetables without
+// bridged or footpath connections).
+void update_partitions(
+    csa_timetable&, search_dir,
+    std::vector<std::pair<std::size_t, std::size_t>> ranges);
+
 }  // namespace motis::csa
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <iostream>
+#include <iterator>
 #include <map>
 
 #include "utl/erase_if.h"
@@ -60,21 +61,47 @@ struct csa_search {
     auto const time_limit = Dir == search_dir::FWD
                                 ? start_time_ + MAX_TRAVEL_TIME
                                 : start_time_ - MAX_TRAVEL_TIME;
+    auto const time_limit_reached = [&](csa_connection const& con) {
+      return Dir == search_dir::FWD ? con.departure_ > time_limit
+                                    : con.arrival_ < time_limit;
+    };
+
+    auto const& partitions =
+        Dir == search_dir::FWD ? tt_.fwd_partitions_ : tt_.bwd_partitions_;
+    auto partition = std::upper_bound(
+        begin(partitions), end(partitions),
+        static_cast<uint32_t>(
+            std::distance(begin(connections), first_connection)),
+        [](uint32_t const idx, csa_partition const& p) { return idx < p.to_; });
 
     for (auto it = first_connection; it != end(connections); ++it) {
       auto const& con = *it;
+      if (time_limit_reached(con)) {
+        break;
+      }
+
+      auto const idx =
+          static_cast<uint32_t>(std::distance(begin(connections), it));
+      if (partition != end(partitions) && idx == partition->to_) {
+        ++partition;
+      }
+      if (partition != end(partitions) &&
+          (it == first_connection || idx == partition->from_) &&
+          !can_improve(*partition)) {
+        auto const last = std::partition_point(
+            it, std::next(begin(connections), partition->to_),
+            [&](csa_connection const& c) { return !time_limit_reached(c); });
+        stats_.partitions_skipped_++;
+        stats_.connections_skipped_ +=
+            static_cast<uint64_t>(std::distance(it, last));
+        it = std::prev(last);
+        continue;
+      }
 
       auto& trip_reachable = trip_reachable_[con.trip_];
       auto const& from_arrival_time = arrival_time_[con.from_station_];
       auto const& to_arrival_time = arrival_time_[con.to_station_];
 
-      auto const time_limit_reached = Dir == search_dir::FWD
-                                          ? con.departure_ > time_limit
-                                          : con.arrival_ < time_limit;
-      if (time_limit_reached) {
-        break;
-      }
-
       stats_.connections_scanned_++;
 
       for (auto transfers = 0; transfers < MAX_TRANSFERS; ++transfers) {
@@ -109,6 +136,31 @@ struct csa_search {
     }
   }
 
+  // A connection of the partition can only be used if the search reached
+  // one of its entry stations before the partition ends or one of its
+  // through trips is reachable already.
+  bool can_improve(csa_partition const& p) const {
+    auto const& connections =
+        Dir == search_dir::FWD ? tt_.fwd_connections_ : tt_.bwd_connections_;
+    auto const& last = connections[p.to_ - 1U];
+    auto const reached = [&](time const t) {
+      return Dir == search_dir::FWD ? t <= last.departure_
+                                    : t != INVALID && t >= last.arrival_;
+    };
+    return std::any_of(begin(p.entry_stations_), end(p.entry_stations_),
+                       [&](station_id const s) {
+                         auto const& arrival = arrival_time_[s];
+                         return std::any_of(begin(arrival), end(arrival),
+                                            reached);
+                       }) ||
+           std::any_of(begin(p.through_trips_), end(p.through_trips_),
+                       [&](trip_id const t) {
+                         auto const& reachable = trip_reachable_[t];
+                         return std::any_of(begin(reachable), end(reachable),
+                                            [](bool const r) { return r; });
+                       });
+  }
+
   void expand_footpaths(csa_station const& station, time station_arrival,
                         int transfers) {
     if (Dir == search_dir::FWD) {
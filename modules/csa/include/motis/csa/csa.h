@@ -3,6 +3,7 @@
 #include "motis/module/module.h"
 
 #include "motis/csa/csa_implementation_type.h"
+#include "motis/csa/update_csa_timetable.h"
 
 #ifdef MOTIS_CUDA
 #include "motis/csa/gpu/gpu_timetable.h"
@@ -10,8 +11,6 @@
 
 namespace motis::csa {
 
-struct csa_timetable;
-
 struct csa : public motis::module::module {
   csa();
   ~csa() override;
@@ -32,6 +31,10 @@ struct csa : public motis::module::module {
   motis::module::msg_ptr route(motis::module::msg_ptr const&,
                                implementation_type) const;
 
+  void rt_update(motis::module::msg_ptr const&);
+  void rt_graph_updated(motis::module::msg_ptr const&);
+  void require_rebuild();
+
 #ifdef MOTIS_CUDA
   bool bridge_zero_duration_connections_{true};
   bool add_footpath_connections_{true};
@@ -41,6 +44,15 @@ struct csa : public motis::module::module {
 #endif
   std::unique_ptr<csa_timetable> timetable_;
   bool import_successful_{false};
+
+  // full rebuild under the schedule write lock on the next /rt/graph_updated
+  // if a real-time update could not be applied in place
+  bool rt_rebuild_{false};
+
+  // set if a real-time update could not be applied in place
+  // (reset by a rebuild)
+  bool rebuild_required_{false};
+  csa_update_stats rt_stats_;
 };
 
 }  // namespace motis::csa
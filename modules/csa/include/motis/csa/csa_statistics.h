@@ -10,6 +10,8 @@ struct csa_statistics {
   uint64_t start_count_{};
   uint64_t destination_count_{};
   uint64_t connections_scanned_{};
+  uint64_t partitions_skipped_{};
+  uint64_t connections_skipped_{};
   uint64_t footpaths_expanded_{};
   uint64_t reconstruction_count_{};
   uint64_t reachable_via_station_{};
@@ -33,6 +35,8 @@ inline stats_category to_stats_category(char const* name,
           {{"start_count", s.start_count_},
            {"destination_count", s.destination_count_},
            {"connections_scanned", s.connections_scanned_},
+           {"partitions_skipped", s.partitions_skipped_},
+           {"connections_skipped", s.connections_skipped_},
            {"footpaths_expanded", s.footpaths_expanded_},
            {"reconstruction_count", s.reconstruction_count_},
            {"reachable_via_station", s.reachable_via_station_},
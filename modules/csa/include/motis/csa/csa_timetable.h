@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <tuple>
 #include <vector>
@@ -24,6 +25,8 @@ using station_id = uint32_t;
 using trip_id = uint32_t;
 using con_idx_t = uint16_t;
 
+constexpr auto const INVALID_TRIP = std::numeric_limits<trip_id>::max();
+
 struct csa_connection {
   csa_connection() = delete;
   csa_connection(uint32_t from_station, uint32_t to_station,
@@ -72,13 +75,29 @@ struct csa_station {
   station const* station_ptr_;
 };
 
+// Connections of one time window of fwd_connections_ (by departure) or
+// bwd_connections_ (by arrival). A search can only use a connection of the
+// partition if it reaches one of the entry stations (in time) or one of the
+// trips continuing from earlier partitions is reachable.
+struct csa_partition {
+  uint32_t from_{0U}, to_{0U};  // connection indices [from_, to_)
+  std::vector<station_id> entry_stations_;
+  std::vector<trip_id> through_trips_;
+};
+
 struct csa_timetable {
   std::vector<csa_station> stations_;
   std::vector<csa_connection> fwd_connections_, bwd_connections_;
   std::vector<uint32_t> fwd_bucket_starts_, bwd_bucket_starts_;
+  std::vector<csa_partition> fwd_partitions_, bwd_partitions_;
 
   std::vector<std::vector<csa_connection const*>> trip_to_connections_;
 
+  // schedule trip (trip::trip_idx_) -> csa trip, only available if every
+  // connection belongs to exactly one trip section (no bridged or footpath
+  // connections), used for real-time updates
+  std::vector<trip_id> sched_trip_to_trip_;
+
 #ifdef MOTIS_CUDA
   gpu_timetable gpu_timetable_;
 #endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/csa/csa_timetable.h"
+
+namespace motis::csa {
+
+struct csa_update_stats {
+  std::uint64_t updated_trips_{0U};
+  std::uint64_t updated_connections_{0U};
+  std::uint64_t moved_connections_{0U};  // connections shifted by re-sorting
+};
+
+// Timetables with bridged or footpath connections can only be rebuilt.
+inline bool is_updatable(csa_timetable const& tt) {
+  return !tt.sched_trip_to_trip_.empty();
+}
+
+// Applies the current real-time state of the given trips (and all trips
+// merged with them) to the timetable: event times, cancellations and the
+// light connections of separated trips. Connections are moved to their new
+// position in fwd_connections_/bwd_connections_ and all references to them
+// (trip and station connection lists, bucket starts) are patched, the
+// partitions of the changed time windows are recomputed.
+//
+// Returns false if a trip can not be updated in place (unknown trip or
+// changed stop sequence): the timetable has to be rebuilt in this case.
+// All other trips are updated anyway.
+bool update_csa_timetable(schedule const&, csa_timetable&,
+                          std::vector<trip const*> const& trips,
+                          csa_update_stats&);
+
+}  // namespace motis::csa
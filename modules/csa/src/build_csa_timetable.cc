@@ -3,6 +3,8 @@
 #include <ciso646>
 #include <algorithm>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <queue>
 #include <set>
@@ -13,6 +15,7 @@
 #endif
 
 #include "utl/enumerate.h"
+#include "utl/erase_duplicates.h"
 #include "utl/pipes/range.h"
 #include "utl/progress_tracker.h"
 #include "utl/to_vec.h"
@@ -39,6 +42,104 @@ inline bool is_same_bucket(time const a, time const b) {
   return get_bucket(a) == get_bucket(b);
 };
 
+inline int get_start_bucket(csa_connection const& c, search_dir const dir) {
+  return get_bucket(dir == search_dir::FWD ? c.departure_ : c.arrival_);
+}
+
+constexpr auto const PARTITION_SIZE = 60U;  // minutes
+
+inline uint32_t get_window(csa_connection const& c, search_dir const dir) {
+  return (dir == search_dir::FWD ? c.departure_ : c.arrival_) / PARTITION_SIZE;
+}
+
+// Partitions of the connections in [from, to) (one per time window).
+// first_window(trip) is the window of the first partition with a connection
+// of the trip: the trip continues from an earlier partition in all others.
+template <typename FirstWindowFn>
+std::vector<csa_partition> get_partitions(
+    std::vector<csa_connection> const& connections, std::size_t const from,
+    std::size_t const to, search_dir const dir,
+    FirstWindowFn&& first_window) {
+  auto partitions = std::vector<csa_partition>{};
+  auto const finish = [](csa_partition& p) {
+    utl::erase_duplicates(p.entry_stations_);
+    utl::erase_duplicates(p.through_trips_);
+  };
+
+  for (auto i = from; i != to; ++i) {
+    auto const& con = connections[i];
+    auto const window = get_window(con, dir);
+    if (partitions.empty() ||
+        get_window(connections[partitions.back().from_], dir) != window) {
+      if (!partitions.empty()) {
+        finish(partitions.back());
+      }
+      partitions.emplace_back().from_ = static_cast<uint32_t>(i);
+    }
+
+    auto& p = partitions.back();
+    p.to_ = static_cast<uint32_t>(i + 1U);
+    if (dir == search_dir::FWD ? con.from_in_allowed_ : con.to_out_allowed_) {
+      p.entry_stations_.push_back(dir == search_dir::FWD ? con.from_station_
+                                                         : con.to_station_);
+    }
+    if (first_window(con.trip_) != window) {
+      p.through_trips_.push_back(con.trip_);
+    }
+  }
+  if (!partitions.empty()) {
+    finish(partitions.back());
+  }
+
+  return partitions;
+}
+
+std::vector<csa_partition> get_partitions(
+    std::vector<csa_connection> const& connections, uint32_t const trip_count,
+    search_dir const dir) {
+  constexpr auto const NO_WINDOW = std::numeric_limits<uint32_t>::max();
+  auto first_windows = std::vector<uint32_t>(trip_count, NO_WINDOW);
+  for (auto const& con : connections) {
+    if (first_windows[con.trip_] == NO_WINDOW) {
+      first_windows[con.trip_] = get_window(con, dir);
+    }
+  }
+  return get_partitions(
+      connections, 0U, connections.size(), dir,
+      [&](trip_id const trip) { return first_windows[trip]; });
+}
+
+// Requires trip_to_connections_ (no bridged or footpath connections).
+uint32_t get_first_window(csa_timetable const& tt, trip_id const trip,
+                          search_dir const dir) {
+  auto const& trip_cons = tt.trip_to_connections_[trip];
+  utl::verify(!trip_cons.empty(), "csa partitions: trip without connections");
+  auto first = get_window(*trip_cons.front(), dir);
+  for (auto const c : trip_cons) {
+    auto const window = get_window(*c, dir);
+    if (dir == search_dir::FWD ? window < first : window > first) {
+      first = window;
+    }
+  }
+  return first;
+}
+
+std::vector<uint32_t> get_all_bucket_starts(
+    std::vector<csa_connection> const& connections, search_dir const dir,
+    bool const bridged) {
+  if (connections.empty()) {
+    return {};
+  }
+
+  auto bucket_starts =
+      get_bucket_starts(connections, 0U, connections.size(), dir, bridged);
+  bucket_starts.emplace_back(static_cast<uint32_t>(connections.size()));
+
+  LOG(info) << "CSA bucket count: " << bucket_starts.size() - 1;
+
+  return bucket_starts;
+}
+
 void init_trip_to_connections(csa_timetable& tt,
                               utl::progress_tracker_ptr& progress_tracker) {
   scoped_timer const timer("csa: trip to connections");
@@ -74,76 +175,6 @@ void init_stop_to_connections(csa_timetable& tt,
   }
 }
 
-std::vector<uint32_t> get_bucket_starts(
-    std::vector<csa_connection>::const_iterator const it_begin,
-    std::vector<csa_connection>::const_iterator const it_end,
-    search_dir const dir, bool const bridged) {
-  if (it_begin == it_end) {
-    return {};
-  }
-
-  auto const get_start_bucket = [&](csa_connection const& c) {
-    return get_bucket(dir == search_dir::FWD ? c.departure_ : c.arrival_);
-  };
-  auto const get_dest_bucket = [&](csa_connection const& c) {
-    return get_bucket(dir == search_dir::FWD ? c.arrival_ : c.departure_);
-  };
-  auto const get_start_station = [&](csa_connection const& c) {
-    return dir == search_dir::FWD ? c.from_station_ : c.to_station_;
-  };
-  auto const get_dest_station = [&](csa_connection const& c) {
-    return dir == search_dir::FWD ? c.to_station_ : c.from_station_;
-  };
-
-  auto bucket_starts = std::vector<uint32_t>{0U};
-  auto curr_bucket = get_start_bucket(*it_begin);
-
-  if (it_begin != it_end) {
-    auto i = 1U;
-
-    if (bridged) {
-      // Bridge connections were inserted.
-      // Buckets = minutes.
-      for (auto const& curr_con : utl::range{std::next(it_begin), it_end}) {
-        if (curr_bucket != get_start_bucket(curr_con)) {
-          bucket_starts.emplace_back(i);
-          curr_bucket = get_start_bucket(curr_con);
-        }
-        ++i;
-      }
-    } else {
-      // Stores arrivals of connections
-      // that depart and arrive within the same bucket.
-      auto same_bucket_arrival =
-          std::set<std::pair<station_id /* arrival station */,
-                             time /* arrival time */>>{};
-      auto curr_start_bucket = get_start_bucket(*it_begin);
-      for (auto it = std::next(it_begin); it != it_end; ++it, ++i) {
-        auto const& curr_con = *it;
-        if (curr_start_bucket != get_start_bucket(curr_con) ||
-            same_bucket_arrival.find(
-                {get_start_station(curr_con), get_start_bucket(curr_con)}) !=
-                end(same_bucket_arrival)) {
-          bucket_starts.emplace_back(i);
-          same_bucket_arrival.clear();
-          curr_start_bucket = get_start_bucket(curr_con);
-        }
-        if (curr_con.get_duration() == 0U) {
-          same_bucket_arrival.emplace(get_dest_station(curr_con),
-                                      get_dest_bucket(curr_con));
-        }
-      }
-    }
-  }
-
-  bucket_starts.emplace_back(
-      static_cast<uint32_t>(std::distance(it_begin, it_end)));
-
-  LOG(info) << "CSA bucket count: " << bucket_starts.size() - 1;
-
-  return bucket_starts;
-}
-
 trip_id get_connections_from_expanded_trips(
     csa_timetable& tt, schedule const& sched,
     bool bridge_zero_duration_connections, bool add_footpath_connections,
@@ -158,6 +189,11 @@ trip_id get_connections_from_expanded_trips(
     progress_tracker->status("Build Connections")
         .out_bounds(0.F, 15.F)
         .in_high(sched.expanded_trips_.index_size());
+#ifndef MOTIS_CUDA  // the gpu timetable is not patched by real-time updates
+    if (!bridge_zero_duration_connections && !add_footpath_connections) {
+      tt.sched_trip_to_trip_.resize(sched.trip_mem_.size(), INVALID_TRIP);
+    }
+#endif
     auto route_idx = 0U;
     for (auto const& route_trips : sched.expanded_trips_) {
       if ((++route_idx % 1000) == 0) {
@@ -177,6 +213,9 @@ trip_id get_connections_from_expanded_trips(
           });
 
       for (auto const& trp : route_trips) {
+        if (!tt.sched_trip_to_trip_.empty()) {
+          tt.sched_trip_to_trip_[trp->trip_idx_] = trip_idx;
+        }
         auto const trp_sections = sections{trp};
         for (auto sec_it = trp_sections.begin(); sec_it != trp_sections.end();
              ++sec_it) {
@@ -260,9 +299,7 @@ trip_id get_connections_from_expanded_trips(
     boost::sort::parallel_stable_sort(
 #endif
         std::begin(tt.fwd_connections_), std::end(tt.fwd_connections_),
-        [&](csa_connection const& c1, csa_connection const& c2) -> bool {
-          return c1.departure_ < c2.departure_;
-        });
+        fwd_connection_order);
 
     progress_tracker->update(50);
     tt.bwd_connections_ = tt.fwd_connections_;
@@ -274,21 +311,19 @@ trip_id get_connections_from_expanded_trips(
     boost::sort::parallel_stable_sort(
 #endif
         std::begin(tt.bwd_connections_), std::end(tt.bwd_connections_),
-        [&](csa_connection const& c1, csa_connection const& c2) -> bool {
-          return c1.arrival_ > c2.arrival_;
-        });
+        bwd_connection_order);
   }
 
   {
     scoped_timer const sort_timer{"csa: compute buckets"};
     progress_tracker->status("Compute Buckets").out_bounds(35.F, 40.F);
     tt.fwd_bucket_starts_ =
-        get_bucket_starts(begin(tt.fwd_connections_), end(tt.fwd_connections_),
-                          search_dir::FWD, bridge_zero_duration_connections);
+        get_all_bucket_starts(tt.fwd_connections_, search_dir::FWD,
+                              bridge_zero_duration_connections);
     progress_tracker->update(50);
     tt.bwd_bucket_starts_ =
-        get_bucket_starts(begin(tt.bwd_connections_), end(tt.bwd_connections_),
-                          search_dir::BWD, bridge_zero_duration_connections);
+        get_all_bucket_starts(tt.bwd_connections_, search_dir::BWD,
+                              bridge_zero_duration_connections);
   }
 
   assert(trip_idx == sched.expanded_trips_.element_count());
@@ -308,6 +343,162 @@ void add_footpaths(schedule const& sched, csa_timetable& tt) {
 
 }  // namespace
 
+std::vector<uint32_t> get_bucket_starts(
+    std::vector<csa_connection> const& connections, std::size_t const from,
+    std::size_t const to, search_dir const dir, bool const bridged) {
+  if (from == to) {
+    return {};
+  }
+
+  auto const get_dest_bucket = [&](csa_connection const& c) {
+    return get_bucket(dir == search_dir::FWD ? c.arrival_ : c.departure_);
+  };
+  auto const get_start_station = [&](csa_connection const& c) {
+    return dir == search_dir::FWD ? c.from_station_ : c.to_station_;
+  };
+  auto const get_dest_station = [&](csa_connection const& c) {
+    return dir == search_dir::FWD ? c.to_station_ : c.from_station_;
+  };
+
+  auto bucket_starts = std::vector<uint32_t>{static_cast<uint32_t>(from)};
+  auto curr_bucket = get_start_bucket(connections[from], dir);
+
+  if (bridged) {
+    // Bridge connections were inserted.
+    // Buckets = minutes.
+    for (auto i = from + 1; i != to; ++i) {
+      if (curr_bucket != get_start_bucket(connections[i], dir)) {
+        bucket_starts.emplace_back(static_cast<uint32_t>(i));
+        curr_bucket = get_start_bucket(connections[i], dir);
+      }
+    }
+  } else {
+    // Stores arrivals of connections
+    // that depart and arrive within the same bucket.
+    auto same_bucket_arrival =
+        std::set<std::pair<station_id /* arrival station */,
+                           time /* arrival time */>>{};
+    for (auto i = from + 1; i != to; ++i) {
+      auto const& curr_con = connections[i];
+      if (curr_bucket != get_start_bucket(curr_con, dir) ||
+          same_bucket_arrival.find({get_start_station(curr_con),
+                                    get_start_bucket(curr_con, dir)}) !=
+              end(same_bucket_arrival)) {
+        bucket_starts.emplace_back(static_cast<uint32_t>(i));
+        same_bucket_arrival.clear();
+        curr_bucket = get_start_bucket(curr_con, dir);
+      }
+      if (curr_con.get_duration() == 0U) {
+        same_bucket_arrival.emplace(get_dest_station(curr_con),
+                                    get_dest_bucket(curr_con));
+      }
+    }
+  }
+
+  return bucket_starts;
+}
+
+void update_bucket_starts(std::vector<uint32_t>& bucket_starts,
+                          std::vector<csa_connection> const& connections,
+                          std::size_t const from, std::size_t const to,
+                          search_dir const dir) {
+  if (bucket_starts.empty() || from == to) {
+    return;
+  }
+
+  // a new minute always starts a new bucket:
+  // recompute the buckets of all minutes overlapping [from, to)
+  auto begin_idx = from;
+  while (begin_idx != 0U &&
+         get_start_bucket(connections[begin_idx - 1], dir) ==
+             get_start_bucket(connections[begin_idx], dir)) {
+    --begin_idx;
+  }
+  auto end_idx = to;
+  while (end_idx != connections.size() &&
+         get_start_bucket(connections[end_idx], dir) ==
+             get_start_bucket(connections[end_idx - 1], dir)) {
+    ++end_idx;
+  }
+
+  auto const updated =
+      get_bucket_starts(connections, begin_idx, end_idx, dir, false);
+  auto const first = std::lower_bound(begin(bucket_starts), end(bucket_starts),
+                                      static_cast<uint32_t>(begin_idx));
+  auto const last = std::lower_bound(first, end(bucket_starts),
+                                     static_cast<uint32_t>(end_idx));
+  bucket_starts.insert(bucket_starts.erase(first, last), begin(updated),
+                       end(updated));
+}
+
+void build_partitions(csa_timetable& tt) {
+  scoped_timer const timer("csa: compute partitions");
+  tt.fwd_partitions_ =
+      get_partitions(tt.fwd_connections_, tt.trip_count_, search_dir::FWD);
+  tt.bwd_partitions_ =
+      get_partitions(tt.bwd_connections_, tt.trip_count_, search_dir::BWD);
+  LOG(info) << "CSA partition count: " << tt.fwd_partitions_.size();
+}
+
+void update_partitions(
+    csa_timetable& tt, search_dir const dir,
+    std::vector<std::pair<std::size_t, std::size_t>> ranges) {
+  auto const& connections =
+      dir == search_dir::FWD ? tt.fwd_connections_ : tt.bwd_connections_;
+  auto& partitions =
+      dir == search_dir::FWD ? tt.fwd_partitions_ : tt.bwd_partitions_;
+  if (ranges.empty()) {
+    return;
+  }
+
+  auto first_windows = std::map<trip_id, uint32_t>{};
+  auto const first_window = [&](trip_id const trip) {
+    auto it = first_windows.find(trip);
+    if (it == end(first_windows)) {
+      it = first_windows.emplace(trip, get_first_window(tt, trip, dir)).first;
+    }
+    return it->second;
+  };
+
+  // The partition bounds are only outdated inside of the ranges.
+  auto const partition_of = [&](std::size_t const idx) {
+    return static_cast<std::size_t>(std::distance(
+        begin(partitions),
+        std::upper_bound(begin(partitions), end(partitions), idx,
+                         [](std::size_t const i, csa_partition const& p) {
+                           return i < p.to_;
+                         })));
+  };
+
+  // Partitions [first, last] to recompute: they begin and end with
+  // connections that did not change, so the windows of all other partitions
+  // stay the same. So do their through trips: the first window of a trip
+  // can only move to or from a window between the old and the new position
+  // of one of its connections.
+  std::sort(begin(ranges), end(ranges));
+  auto rebuild = std::vector<std::pair<std::size_t, std::size_t>>{};
+  for (auto const& [from, to] : ranges) {
+    auto const first = partition_of(from == 0U ? 0U : from - 1U);
+    auto const last = partition_of(std::min(to, connections.size() - 1U));
+    if (!rebuild.empty() && first <= rebuild.back().second) {
+      rebuild.back().second = std::max(rebuild.back().second, last);
+    } else {
+      rebuild.emplace_back(first, last);
+    }
+  }
+  for (auto it = rbegin(rebuild); it != rend(rebuild); ++it) {
+    auto const [first, last] = *it;
+    auto updated =
+        get_partitions(connections, partitions[first].from_,
+                       partitions[last].to_, dir, first_window);
+    auto const pos = partitions.erase(
+        std::next(begin(partitions), static_cast<std::ptrdiff_t>(first)),
+        std::next(begin(partitions), static_cast<std::ptrdiff_t>(last + 1U)));
+    partitions.insert(pos, std::make_move_iterator(begin(updated)),
+                      std::make_move_iterator(end(updated)));
+  }
+}
+
 std::unique_ptr<csa_timetable> build_csa_timetable(
     schedule const& sched, bool const bridge_zero_duration_connections,
     bool const add_footpath_connections) {
@@ -329,6 +520,7 @@ std::unique_ptr<csa_timetable> build_csa_timetable(
 
   init_trip_to_connections(*tt, progress_tracker);
   init_stop_to_connections(*tt, progress_tracker);
+  build_partitions(*tt);
 
 #ifdef MOTIS_CUDA
   {
@@ -1,6 +1,11 @@
 #include "motis/csa/csa.h"
 
+#include <system_error>
+#include <vector>
+
+#include "motis/core/common/logging.h"
 #include "motis/core/access/time_access.h"
+#include "motis/core/conv/trip_conv.h"
 #include "motis/core/journey/journeys_to_message.h"
 #include "motis/module/event_collector.h"
 
@@ -12,8 +17,10 @@
 #include "motis/csa/error.h"
 #include "motis/csa/run_csa_search.h"
 
+using namespace motis::logging;
 using namespace motis::module;
 using namespace motis::routing;
+using namespace motis::rt;
 
 namespace motis::csa {
 
@@ -22,6 +29,9 @@ csa::csa() : module("CSA", "csa") {
         "Bridge zero duration connections (required for GPU CSA)");
   param(add_footpath_connections_, "expand_footpaths",
         "Add CSA connections representing connection and footpath");
+  param(rt_rebuild_, "rt_rebuild",
+        "Rebuild the timetable after real-time updates that cannot be "
+        "applied in place (otherwise: /csa/update_timetable)");
 }
 
 csa::~csa() = default;
@@ -77,11 +87,113 @@ void csa::init(motis::module::registry& reg) {
         timetable_ =
             build_csa_timetable(get_sched(), bridge_zero_duration_connections_,
                                 add_footpath_connections_);
+        rebuild_required_ = false;
         return {};
       },
       ctx::accesses_t{ctx::access_request{
           to_res_id(::motis::module::global_res_id::SCHEDULE),
           ctx::access_t::WRITE}});
+
+  reg.subscribe(
+      "/rt/update",
+      [&](msg_ptr const& msg) -> msg_ptr {
+        rt_update(msg);
+        return nullptr;
+      },
+      ctx::accesses_t{ctx::access_request{
+          to_res_id(::motis::module::global_res_id::SCHEDULE),
+          ctx::access_t::WRITE}});
+
+  reg.subscribe(
+      "/rt/graph_updated",
+      [&](msg_ptr const& msg) -> msg_ptr {
+        rt_graph_updated(msg);
+        return nullptr;
+      },
+      ctx::accesses_t{ctx::access_request{
+          to_res_id(::motis::module::global_res_id::SCHEDULE),
+          ctx::access_t::WRITE}});
+}
+
+void csa::rt_update(msg_ptr const& msg) {
+  auto const update = motis_content(RtUpdates, msg);
+  if (update->schedule() != 0U || timetable_ == nullptr ||
+      (rebuild_required_ && rt_rebuild_)) {
+    return;
+  }
+  if (!is_updatable(*timetable_)) {
+    require_rebuild();
+    return;
+  }
+
+  auto const& sched = get_sched();
+  auto trips = std::vector<trip const*>{};
+  try {
+    for (auto const& u : *update->updates()) {
+      if (u->intermediate()) {
+        continue;
+      }
+      switch (u->content_type()) {
+        case Content_RtDelayUpdate:
+          trips.emplace_back(from_fbs(
+              sched,
+              reinterpret_cast<RtDelayUpdate const*>(u->content())->trip()));
+          break;
+        case Content_RtRerouteUpdate:
+          trips.emplace_back(from_fbs(
+              sched,
+              reinterpret_cast<RtRerouteUpdate const*>(u->content())->trip()));
+          break;
+        case Content_RtExpandedTripUpdate: {
+          auto const etu =
+              reinterpret_cast<RtExpandedTripUpdate const*>(u->content());
+          if (etu->update_type() == RtExpandedTripUpdateType_TripAdded) {
+            require_rebuild();
+          } else {
+            trips.emplace_back(sched.trip_mem_.at(etu->trip_index()).get());
+          }
+          break;
+        }
+        case Content_RtStationAdded: require_rebuild(); break;
+        default: break;
+      }
+    }
+  } catch (std::system_error const& e) {
+    LOG(warn) << "csa: trip of real-time update not found: " << e.what();
+    require_rebuild();
+  }
+
+  if (!(rebuild_required_ && rt_rebuild_) &&
+      !update_csa_timetable(sched, *timetable_, trips, rt_stats_)) {
+    require_rebuild();
+  }
+}
+
+void csa::require_rebuild() {
+  if (!rebuild_required_ && !rt_rebuild_) {
+    LOG(warn) << "csa: real-time update not applicable in place, timetable "
+                 "is outdated until /csa/update_timetable is called";
+  }
+  rebuild_required_ = true;
+}
+
+void csa::rt_graph_updated(msg_ptr const& msg) {
+  if (motis_content(RtGraphUpdated, msg)->schedule() != 0U) {
+    return;
+  }
+  if (rebuild_required_ && rt_rebuild_) {
+    LOG(info) << "csa: real-time update not applicable in place, rebuilding";
+    timetable_ =
+        build_csa_timetable(get_sched(), bridge_zero_duration_connections_,
+                            add_footpath_connections_);
+    rebuild_required_ = false;
+  } else if (rt_stats_.updated_trips_ != 0U) {
+    LOG(info) << "csa: real-time update: " << rt_stats_.updated_trips_
+              << " trips, " << rt_stats_.updated_connections_
+              << " connections updated, " << rt_stats_.moved_connections_
+              << " connections moved";
+  }
+  rt_stats_ = {};
 }
 
 csa_timetable const* csa::get_timetable() const { return timetable_.get(); }
@@ -0,0 +1,204 @@
+#include "motis/csa/update_csa_timetable.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "utl/verify.h"
+
+#include "motis/core/access/trip_iterator.h"
+
+#include "motis/csa/build_csa_timetable.h"
+
+using namespace motis::access;
+
+namespace motis::csa {
+
+namespace {
+
+using index_range = std::pair<std::size_t, std::size_t>;
+
+// Connections whose partitions have to be recomputed.
+struct changed_connections {
+  std::vector<index_range> fwd_, bwd_;
+};
+
+// Moves the (already updated) connection at index i to its position according
+// to the given order. Returns the index range of the shifted connections.
+template <typename Order>
+index_range reposition(std::vector<csa_connection>& connections,
+                       std::size_t const i, Order&& order) {
+  auto const first = begin(connections);
+  auto const con = std::next(first, static_cast<std::ptrdiff_t>(i));
+  if (con != first && order(*con, *std::prev(con))) {
+    auto const pos = std::upper_bound(first, con, *con, order);
+    std::rotate(pos, con, std::next(con));
+    return {static_cast<std::size_t>(std::distance(first, pos)), i + 1};
+  } else if (std::next(con) != end(connections) &&
+             order(*std::next(con), *con)) {
+    auto const pos =
+        std::upper_bound(std::next(con), end(connections), *con, order);
+    std::rotate(con, std::next(con), pos);
+    return {i, static_cast<std::size_t>(std::distance(first, pos))};
+  }
+  return {i, i + 1};
+}
+
+// Updates all pointers to the fwd connections in the given range.
+void update_references(csa_timetable& tt, index_range const range) {
+  auto const first = &tt.fwd_connections_[range.first];
+  auto const last = std::next(first, range.second - range.first);
+
+  for (auto c = first; c != last; ++c) {
+    tt.trip_to_connections_[c->trip_][c->trip_con_idx_] = c;
+  }
+
+  // station connection lists are ordered like fwd_connections_:
+  // the pointers into the range form one block in every list
+  auto const block_begin = [&](std::vector<csa_connection const*> const& v) {
+    return static_cast<std::size_t>(std::distance(
+        begin(v), std::lower_bound(begin(v), end(v), first,
+                                   std::less<csa_connection const*>{})));
+  };
+  auto outgoing_pos = std::map<station_id, std::size_t>{};
+  auto incoming_pos = std::map<station_id, std::size_t>{};
+  for (auto c = first; c != last; ++c) {
+    auto& outgoing = tt.stations_[c->from_station_].outgoing_connections_;
+    auto out_it = outgoing_pos.find(c->from_station_);
+    if (out_it == end(outgoing_pos)) {
+      out_it = outgoing_pos.emplace(c->from_station_, block_begin(outgoing))
+                   .first;
+    }
+    outgoing[out_it->second++] = c;
+
+    auto& incoming = tt.stations_[c->to_station_].incoming_connections_;
+    auto in_it = incoming_pos.find(c->to_station_);
+    if (in_it == end(incoming_pos)) {
+      in_it =
+          incoming_pos.emplace(c->to_station_, block_begin(incoming)).first;
+    }
+    incoming[in_it->second++] = c;
+  }
+}
+
+bool matches_route(csa_timetable const& tt, trip_id const id,
+                   trip const* trp) {
+  auto const& trip_cons = tt.trip_to_connections_[id];
+  if (sections{trp}.size() != trip_cons.size()) {
+    return false;
+  }
+  for (auto const& sec : sections{trp}) {
+    auto const c = trip_cons[sec.index()];
+    if (c->from_station_ != sec.from_station_id() ||
+        c->to_station_ != sec.to_station_id()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool update_trip(csa_timetable& tt, trip const* trp, csa_update_stats& stats,
+                 changed_connections& changed) {
+  if (trp->trip_idx_ >= tt.sched_trip_to_trip_.size()) {
+    return false;  // trip added after the timetable was built
+  }
+  auto const id = tt.sched_trip_to_trip_[trp->trip_idx_];
+  if (id == INVALID_TRIP || !matches_route(tt, id, trp)) {
+    return false;
+  }
+
+  auto const& trip_cons = tt.trip_to_connections_[id];
+  for (auto const& sec : sections{trp}) {
+    auto const& lcon = sec.lcon();
+    auto const valid = lcon.valid_ != 0U;
+    auto const in_allowed = valid && sec.from_node()->is_in_allowed();
+    auto const out_allowed = valid && sec.to_node()->is_out_allowed();
+
+    auto const fwd_idx = static_cast<std::size_t>(
+        std::distance(tt.fwd_connections_.data(), trip_cons[sec.index()]));
+    auto& fwd_con = tt.fwd_connections_[fwd_idx];
+    auto const times_changed =
+        fwd_con.departure_ != lcon.d_time_ || fwd_con.arrival_ != lcon.a_time_;
+    if (!times_changed && fwd_con.light_con_ == &lcon &&
+        fwd_con.from_in_allowed_ == in_allowed &&
+        fwd_con.to_out_allowed_ == out_allowed) {
+      continue;
+    }
+
+    auto const bwd_it =
+        std::lower_bound(begin(tt.bwd_connections_), end(tt.bwd_connections_),
+                         fwd_con, bwd_connection_order);
+    utl::verify(bwd_it != end(tt.bwd_connections_) &&
+                    bwd_it->trip_ == fwd_con.trip_ &&
+                    bwd_it->trip_con_idx_ == fwd_con.trip_con_idx_,
+                "csa update: connection not found in bwd connections");
+    auto const bwd_idx = static_cast<std::size_t>(
+        std::distance(begin(tt.bwd_connections_), bwd_it));
+
+    for (auto c : {&fwd_con, &*bwd_it}) {
+      c->departure_ = lcon.d_time_;
+      c->arrival_ = lcon.a_time_;
+      c->from_in_allowed_ = in_allowed;
+      c->to_out_allowed_ = out_allowed;
+      c->light_con_ = &lcon;
+    }
+    ++stats.updated_connections_;
+
+    if (!times_changed) {
+      changed.fwd_.emplace_back(fwd_idx, fwd_idx + 1U);
+      changed.bwd_.emplace_back(bwd_idx, bwd_idx + 1U);
+      continue;
+    }
+
+    auto const fwd_moved =
+        reposition(tt.fwd_connections_, fwd_idx, fwd_connection_order);
+    update_references(tt, fwd_moved);
+    update_bucket_starts(tt.fwd_bucket_starts_, tt.fwd_connections_,
+                         fwd_moved.first, fwd_moved.second, search_dir::FWD);
+
+    auto const bwd_moved =
+        reposition(tt.bwd_connections_, bwd_idx, bwd_connection_order);
+    update_bucket_starts(tt.bwd_bucket_starts_, tt.bwd_connections_,
+                         bwd_moved.first, bwd_moved.second, search_dir::BWD);
+
+    stats.moved_connections_ += (fwd_moved.second - fwd_moved.first - 1) +
+                                (bwd_moved.second - bwd_moved.first - 1);
+    changed.fwd_.push_back(fwd_moved);
+    changed.bwd_.push_back(bwd_moved);
+  }
+
+  ++stats.updated_trips_;
+  return true;
+}
+
+}  // namespace
+
+bool update_csa_timetable(schedule const& sched, csa_timetable& tt,
+                          std::vector<trip const*> const& trips,
+                          csa_update_stats& stats) {
+  utl::verify(is_updatable(tt), "csa update: timetable not updatable");
+
+  // merged trips share light connections
+  auto affected = std::set<trip const*>{};
+  for (auto const trp : trips) {
+    affected.insert(trp);
+    for (auto const& sec : sections{trp}) {
+      auto const& merged = *sched.merged_trips_.at(sec.lcon().trips_);
+      affected.insert(begin(merged), end(merged));
+    }
+  }
+
+  auto changed = changed_connections{};
+  auto success = true;
+  for (auto const trp : affected) {
+    success = update_trip(tt, trp, stats, changed) && success;
+  }
+  update_partitions(tt, search_dir::FWD, std::move(changed.fwd_));
+  update_partitions(tt, search_dir::BWD, std::move(changed.bwd_));
+  return success;
+}
+
+}  // namespace motis::csa
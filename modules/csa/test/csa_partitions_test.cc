@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "motis/core/schedule/station.h"
+
+#include "motis/csa/build_csa_timetable.h"
+#include "motis/csa/cpu/csa_search_default_cpu.h"
+
+using namespace motis;
+using namespace motis::csa;
+
+namespace {
+
+csa_connection make_con(station_id const from, station_id const to,
+                        motis::time const dep, motis::time const arr,
+                        trip_id const trip, con_idx_t const idx,
+                        bool const in_allowed = true) {
+  return {from, to, dep, arr, 0U, trip, idx, in_allowed, true,
+          service_class::OTHER, nullptr};
+}
+
+// Line 0 -> 1 -> 2 -> 3 in the first hour and from minute 310 on, line
+// 4 -> 5 in between: searches along one line can skip the other line.
+csa_timetable make_timetable(std::vector<station> const& stations) {
+  csa_timetable tt;
+  for (auto const& st : stations) {
+    tt.stations_.emplace_back(&st);
+  }
+  tt.trip_count_ = 7U;
+  tt.fwd_connections_ = {
+      make_con(0, 1, 10, 20, 0, 0),   make_con(1, 2, 25, 40, 0, 1),
+      make_con(2, 3, 45, 55, 0, 2),   make_con(4, 5, 65, 75, 1, 0),
+      make_con(4, 5, 80, 90, 2, 0),   make_con(4, 5, 130, 140, 3, 0),
+      make_con(4, 5, 190, 200, 4, 0), make_con(4, 5, 250, 260, 5, 0),
+      make_con(0, 1, 310, 320, 6, 0), make_con(1, 2, 370, 380, 6, 1, false)};
+  tt.bwd_connections_ = tt.fwd_connections_;
+  std::sort(begin(tt.bwd_connections_), end(tt.bwd_connections_),
+            bwd_connection_order);
+  build_partitions(tt);
+  return tt;
+}
+
+template <search_dir Dir>
+csa_statistics expect_same_as_full_scan(csa_timetable const& tt,
+                                        station_id const start,
+                                        motis::time const start_time) {
+  auto full_scan_tt = tt;
+  full_scan_tt.fwd_partitions_.clear();
+  full_scan_tt.bwd_partitions_.clear();
+
+  auto stats = csa_statistics{};
+  auto full_scan_stats = csa_statistics{};
+  auto search = cpu::csa_search<Dir>{tt, start_time, stats};
+  auto full_scan =
+      cpu::csa_search<Dir>{full_scan_tt, start_time, full_scan_stats};
+  search.add_start(tt.stations_[start], 0U);
+  full_scan.add_start(full_scan_tt.stations_[start], 0U);
+  search.search();
+  full_scan.search();
+
+  EXPECT_EQ(full_scan.arrival_time_, search.arrival_time_);
+  EXPECT_EQ(full_scan.trip_reachable_, search.trip_reachable_);
+  EXPECT_EQ(0U, full_scan_stats.partitions_skipped_);
+  EXPECT_EQ(full_scan_stats.connections_scanned_,
+            stats.connections_scanned_ + stats.connections_skipped_);
+  return stats;
+}
+
+}  // namespace
+
+TEST(csa_partitions_test, build_partitions) {
+  csa_timetable tt;
+  tt.trip_count_ = 2U;
+  tt.fwd_connections_ = {make_con(0, 1, 10, 20, 0, 0),
+                         make_con(3, 4, 30, 40, 1, 0, false),
+                         make_con(1, 2, 70, 80, 0, 1),
+                         make_con(4, 5, 80, 90, 1, 1),
+                         make_con(5, 6, 130, 140, 1, 2)};
+  tt.bwd_connections_ = {tt.fwd_connections_[4], tt.fwd_connections_[3],
+                         tt.fwd_connections_[2], tt.fwd_connections_[1],
+                         tt.fwd_connections_[0]};
+  build_partitions(tt);
+
+  ASSERT_EQ(3U, tt.fwd_partitions_.size());
+  EXPECT_EQ(0U, tt.fwd_partitions_[0].from_);
+  EXPECT_EQ(2U, tt.fwd_partitions_[0].to_);
+  EXPECT_EQ(std::vector<station_id>{0U}, tt.fwd_partitions_[0].entry_stations_);
+  EXPECT_TRUE(tt.fwd_partitions_[0].through_trips_.empty());
+  EXPECT_EQ(2U, tt.fwd_partitions_[1].from_);
+  EXPECT_EQ(4U, tt.fwd_partitions_[1].to_);
+  EXPECT_EQ((std::vector<station_id>{1U, 4U}),
+            tt.fwd_partitions_[1].entry_stations_);
+  EXPECT_EQ((std::vector<trip_id>{0U, 1U}),
+            tt.fwd_partitions_[1].through_trips_);
+  EXPECT_EQ(std::vector<trip_id>{1U}, tt.fwd_partitions_[2].through_trips_);
+
+  // by arrival: entry stations are the arrival stations
+  ASSERT_EQ(3U, tt.bwd_partitions_.size());
+  EXPECT_EQ(1U, tt.bwd_partitions_[0].to_);
+  EXPECT_EQ(std::vector<station_id>{6U}, tt.bwd_partitions_[0].entry_stations_);
+  EXPECT_EQ((std::vector<station_id>{2U, 5U}),
+            tt.bwd_partitions_[1].entry_stations_);
+  EXPECT_EQ(std::vector<trip_id>{1U}, tt.bwd_partitions_[1].through_trips_);
+  EXPECT_EQ((std::vector<trip_id>{0U, 1U}),
+            tt.bwd_partitions_[2].through_trips_);
+}
+
+TEST(csa_partitions_test, search_skips_partitions) {
+  auto stations = std::vector<station>(6U);
+  for (auto i = 0U; i != stations.size(); ++i) {
+    stations[i].index_ = i;
+  }
+  auto const tt = make_timetable(stations);
+  ASSERT_EQ(7U, tt.fwd_partitions_.size());
+
+  // line 4 -> 5 is skipped
+  auto const fwd = expect_same_as_full_scan<search_dir::FWD>(tt, 0U, 0U);
+  EXPECT_EQ(4U, fwd.partitions_skipped_);
+  EXPECT_EQ(5U, fwd.connections_skipped_);
+
+  // starting inside of a skipped partition
+  auto const fwd_inside =
+      expect_same_as_full_scan<search_dir::FWD>(tt, 0U, 70U);
+  EXPECT_EQ(4U, fwd_inside.partitions_skipped_);
+  EXPECT_EQ(4U, fwd_inside.connections_skipped_);
+
+  // the last partition can only be reached through trip 6
+  auto const fwd_through =
+      expect_same_as_full_scan<search_dir::FWD>(tt, 0U, 300U);
+  EXPECT_EQ(0U, fwd_through.partitions_skipped_);
+  EXPECT_EQ(2U, fwd_through.connections_scanned_);
+
+  auto const bwd = expect_same_as_full_scan<search_dir::BWD>(tt, 3U, 400U);
+  EXPECT_EQ(6U, bwd.partitions_skipped_);
+  EXPECT_EQ(7U, bwd.connections_skipped_);
+
+  // skipping the partition of the first connection
+  auto const other = expect_same_as_full_scan<search_dir::FWD>(tt, 4U, 0U);
+  EXPECT_EQ(3U, other.partitions_skipped_);
+  EXPECT_EQ(5U, other.connections_skipped_);
+}
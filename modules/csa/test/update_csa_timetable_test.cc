@@ -0,0 +1,258 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "utl/verify.h"
+
+#include "motis/core/access/time_access.h"
+#include "motis/core/access/trip_access.h"
+#include "motis/module/message.h"
+
+#include "motis/csa/build_csa_timetable.h"
+#include "motis/csa/csa.h"
+#include "motis/csa/update_csa_timetable.h"
+
+#include "motis/test/motis_instance_test.h"
+#include "motis/test/schedule/invalid_realtime.h"
+#include "motis/test/schedule/update_journey.h"
+
+using namespace motis;
+using namespace motis::csa;
+using namespace motis::module;
+using namespace motis::test;
+using motis::test::schedule::invalid_realtime::dataset_opt_no_rules;
+using motis::test::schedule::update_journey::get_canceled_train_ris_message;
+using motis::test::schedule::update_journey::get_delay_ris_msg;
+
+namespace {
+
+// connection with the schedule trip instead of the csa trip id
+// (csa trip ids of rebuilt timetables differ after trip separations)
+using con_key =
+    std::tuple<motis::time, motis::time, station_id, station_id, uint32_t,
+               con_idx_t, bool, bool, light_connection const*, uint16_t,
+               service_class>;
+
+struct normalized_timetable {
+  explicit normalized_timetable(csa_timetable const& tt)
+      : tt_{tt}, sched_trips_(tt.trip_count_, INVALID_TRIP) {
+    for (auto i = 0U; i != tt.sched_trip_to_trip_.size(); ++i) {
+      if (tt.sched_trip_to_trip_[i] != INVALID_TRIP) {
+        sched_trips_[tt.sched_trip_to_trip_[i]] = i;
+      }
+    }
+  }
+
+  con_key key(csa_connection const& c) const {
+    return {c.departure_,
+            c.arrival_,
+            c.from_station_,
+            c.to_station_,
+            sched_trips_.at(c.trip_),
+            c.trip_con_idx_,
+            c.from_in_allowed_,
+            c.to_out_allowed_,
+            c.light_con_,
+            c.price_,
+            c.clasz_};
+  }
+
+  std::vector<con_key> keys(std::vector<csa_connection> const& cons) const {
+    auto k = std::vector<con_key>{};
+    for (auto const& c : cons) {
+      k.emplace_back(key(c));
+    }
+    std::sort(begin(k), end(k));
+    return k;
+  }
+
+  std::vector<con_key> keys(
+      std::vector<csa_connection const*> const& cons) const {
+    auto k = std::vector<con_key>{};
+    for (auto const c : cons) {
+      k.emplace_back(key(*c));
+    }
+    std::sort(begin(k), end(k));
+    return k;
+  }
+
+  std::vector<uint32_t> sched_trips(std::vector<trip_id> const& ids) const {
+    auto trips = std::vector<uint32_t>{};
+    for (auto const id : ids) {
+      trips.emplace_back(sched_trips_.at(id));
+    }
+    std::sort(begin(trips), end(trips));
+    return trips;
+  }
+
+  bool is_fwd_connection(csa_connection const* c) const {
+    return c >= tt_.fwd_connections_.data() &&
+           c < tt_.fwd_connections_.data() + tt_.fwd_connections_.size();
+  }
+
+  csa_timetable const& tt_;
+  std::vector<uint32_t> sched_trips_;
+};
+
+std::vector<station_id> sorted(std::vector<station_id> v) {
+  std::sort(begin(v), end(v));
+  return v;
+}
+
+void expect_equal_partitions(normalized_timetable const& updated,
+                             std::vector<csa_partition> const& updated_parts,
+                             normalized_timetable const& rebuilt,
+                             std::vector<csa_partition> const& rebuilt_parts) {
+  ASSERT_EQ(rebuilt_parts.size(), updated_parts.size());
+  for (auto i = 0U; i != rebuilt_parts.size(); ++i) {
+    auto const& u = updated_parts[i];
+    auto const& r = rebuilt_parts[i];
+    EXPECT_EQ(r.from_, u.from_);
+    EXPECT_EQ(r.to_, u.to_);
+    EXPECT_EQ(sorted(r.entry_stations_), sorted(u.entry_stations_));
+    EXPECT_EQ(rebuilt.sched_trips(r.through_trips_),
+              updated.sched_trips(u.through_trips_));
+  }
+}
+
+void expect_equal_timetables(csa_timetable const& updated_tt,
+                             csa_timetable const& rebuilt_tt) {
+  auto const updated = normalized_timetable{updated_tt};
+  auto const rebuilt = normalized_timetable{rebuilt_tt};
+
+  // connections and bucket starts
+  EXPECT_TRUE(std::is_sorted(begin(updated_tt.fwd_connections_),
+                             end(updated_tt.fwd_connections_),
+                             fwd_connection_order));
+  EXPECT_TRUE(std::is_sorted(begin(updated_tt.bwd_connections_),
+                             end(updated_tt.bwd_connections_),
+                             bwd_connection_order));
+  EXPECT_EQ(rebuilt.keys(rebuilt_tt.fwd_connections_),
+            updated.keys(updated_tt.fwd_connections_));
+  EXPECT_EQ(rebuilt.keys(rebuilt_tt.bwd_connections_),
+            updated.keys(updated_tt.bwd_connections_));
+  EXPECT_EQ(rebuilt_tt.fwd_bucket_starts_, updated_tt.fwd_bucket_starts_);
+  EXPECT_EQ(rebuilt_tt.bwd_bucket_starts_, updated_tt.bwd_bucket_starts_);
+
+  // trip connection lists
+  ASSERT_EQ(rebuilt_tt.sched_trip_to_trip_.size(),
+            updated_tt.sched_trip_to_trip_.size());
+  for (auto i = 0U; i != rebuilt_tt.sched_trip_to_trip_.size(); ++i) {
+    auto const u_id = updated_tt.sched_trip_to_trip_[i];
+    auto const r_id = rebuilt_tt.sched_trip_to_trip_[i];
+    ASSERT_EQ(r_id == INVALID_TRIP, u_id == INVALID_TRIP);
+    if (r_id == INVALID_TRIP) {
+      continue;
+    }
+
+    auto const& u_cons = updated_tt.trip_to_connections_.at(u_id);
+    auto const& r_cons = rebuilt_tt.trip_to_connections_.at(r_id);
+    ASSERT_EQ(r_cons.size(), u_cons.size());
+    for (auto j = 0U; j != r_cons.size(); ++j) {
+      ASSERT_TRUE(updated.is_fwd_connection(u_cons[j]));
+      EXPECT_EQ(u_id, u_cons[j]->trip_);
+      EXPECT_EQ(j, u_cons[j]->trip_con_idx_);
+      EXPECT_EQ(rebuilt.key(*r_cons[j]), updated.key(*u_cons[j]));
+    }
+  }
+
+  // station connection lists (ordered like fwd_connections_)
+  auto const in_fwd_order = [&](std::vector<csa_connection const*> const& v) {
+    return std::all_of(begin(v), end(v),
+                       [&](csa_connection const* c) {
+                         return updated.is_fwd_connection(c);
+                       }) &&
+           std::is_sorted(begin(v), end(v),
+                          std::less<csa_connection const*>{});
+  };
+  ASSERT_EQ(rebuilt_tt.stations_.size(), updated_tt.stations_.size());
+  for (auto i = 0U; i != rebuilt_tt.stations_.size(); ++i) {
+    auto const& u = updated_tt.stations_[i];
+    auto const& r = rebuilt_tt.stations_[i];
+    EXPECT_TRUE(in_fwd_order(u.outgoing_connections_));
+    EXPECT_TRUE(in_fwd_order(u.incoming_connections_));
+    EXPECT_EQ(rebuilt.keys(r.outgoing_connections_),
+              updated.keys(u.outgoing_connections_));
+    EXPECT_EQ(rebuilt.keys(r.incoming_connections_),
+              updated.keys(u.incoming_connections_));
+  }
+
+  expect_equal_partitions(updated, updated_tt.fwd_partitions_, rebuilt,
+                          rebuilt_tt.fwd_partitions_);
+  expect_equal_partitions(updated, updated_tt.bwd_partitions_, rebuilt,
+                          rebuilt_tt.bwd_partitions_);
+}
+
+}  // namespace
+
+struct csa_update_timetable_test : public motis_instance_test {
+  csa_update_timetable_test()
+      : motis::test::motis_instance_test(
+            dataset_opt_no_rules, {"ris", "rt", "csa"},
+            {"--csa.bridge=false", "--csa.expand_footpaths=false"}) {}
+
+  motis::csa::csa& csa_module() const {
+    auto const modules = instance_->modules();
+    auto const it = std::find_if(begin(modules), end(modules), [](auto&& m) {
+      return m->module_name() == "csa";
+    });
+    utl::verify(it != end(modules), "csa module not found");
+    return *static_cast<motis::csa::csa*>(*it);
+  }
+
+  csa_connection const* get_connection(std::string const& service,
+                                       int const train_nr, int const day_idx,
+                                       std::size_t const section_idx) const {
+    auto const trp =
+        get_trip(sched(), "0000001", train_nr, unix_time(1010, day_idx),
+                 train_nr == 1 ? "0000005" : "0000004",
+                 unix_time(train_nr == 1 ? 1400 : 1300, day_idx), service);
+    auto const& tt = *csa_module().timetable_;
+    return tt.trip_to_connections_
+        .at(tt.sched_trip_to_trip_.at(trp->trip_idx_))
+        .at(section_idx);
+  }
+};
+
+#ifndef MOTIS_CUDA  // the gpu timetable is not updated in place
+
+TEST_F(csa_update_timetable_test, delay_cancel_overtake) {
+  ASSERT_TRUE(is_updatable(*csa_module().timetable_));
+
+  // delay: IC 382 departs 5 minutes late at 0000003
+  publish(get_delay_ris_msg("0000003", 2, event_type::DEP, unix_time(1210),
+                            unix_time(1215), "0000001", unix_time(1010)));
+
+  // overtaking: IC 381 departs 30 minutes late at 0000002,
+  // IC 382 (same schedule times up to 0000004) is now ahead of it
+  publish(get_delay_ris_msg("0000002", 1, event_type::DEP, unix_time(1110),
+                            unix_time(1140), "0000001", unix_time(1010)));
+
+  // cancellation: IC 381 on the second day between 0000002 and 0000003
+  publish(get_canceled_train_ris_message(
+      "0000002", 1, event_type::DEP, unix_time(1110, 1), "0000003",
+      event_type::ARR, unix_time(1200, 1), "0000001", unix_time(1010, 1)));
+
+  publish(make_no_msg("/ris/system_time_changed"));
+
+  ASSERT_FALSE(csa_module().rebuild_required_);
+
+  auto const to_motis_time = [&](int const hhmm) {
+    return unix_to_motistime(sched(), unix_time(hhmm));
+  };
+  EXPECT_EQ(to_motis_time(1215), get_connection("382", 2, 0, 2)->departure_);
+  EXPECT_EQ(to_motis_time(1140), get_connection("381", 1, 0, 1)->departure_);
+  EXPECT_EQ(to_motis_time(1110), get_connection("382", 2, 0, 1)->departure_);
+  EXPECT_FALSE(get_connection("381", 1, 1, 1)->from_in_allowed_);
+  EXPECT_FALSE(get_connection("381", 1, 1, 1)->to_out_allowed_);
+  EXPECT_TRUE(get_connection("381", 1, 1, 0)->from_in_allowed_);
+
+  auto const rebuilt = build_csa_timetable(sched(), false, false);
+  expect_equal_timetables(*csa_module().timetable_, *rebuilt);
+}
+
+#endif
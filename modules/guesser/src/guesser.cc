@@ -38,7 +38,8 @@ void guesser::init(motis::module::registry& reg) {
   reg.register_op(
       "/guesser", [this](msg_ptr const& m) { return guess(m); },
       {kScheduleReadAccess,
-       {to_res_id(global_res_id::GUESSER_DATA), ctx::access_t::READ}});
+       {to_res_id(global_res_id::GUESSER_DATA), ctx::access_t::READ}},
+      kInteractiveOp);
   reg.subscribe(
       "/rt/update",
       [this](msg_ptr const& m) {
@@ -26,6 +26,7 @@ private:
 
   std::string router_{"routing"};
   bool revise_{false};
+  unsigned cache_ttl_{0U};
   ppr_profiles ppr_profiles_;
 };
 
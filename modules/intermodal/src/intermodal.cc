@@ -38,6 +38,8 @@ namespace motis::intermodal {
 intermodal::intermodal() : module("Intermodal Options", "intermodal") {
   param(router_, "router", "routing module");
   param(revise_, "revise", "revise connections");
+  param(cache_ttl_, "cache_ttl",
+        "cache /intermodal responses for this many seconds (0 = disabled)");
 }
 
 intermodal::~intermodal() = default;
@@ -49,7 +51,7 @@ void intermodal::reg_subc(motis::module::subc_reg& r) {
 
 void intermodal::init(motis::module::registry& r) {
   r.register_op("/intermodal", [this](msg_ptr const& m) { return route(m); },
-                {});
+                {}, with_cache_ttl({}, std::chrono::seconds{cache_ttl_}));
   if (router_.empty()) {
     router_ = "/routing";
   } else if (router_[0] != '/') {
@@ -39,6 +39,7 @@ private:
 
   std::unique_ptr<geo::point_rtree> station_geo_index_;
 
+  unsigned station_events_cache_ttl_{0U};
   bool import_successful_{false};
 };
 
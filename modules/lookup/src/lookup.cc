@@ -20,7 +20,11 @@ using namespace motis::module;
 
 namespace motis::lookup {
 
-lookup::lookup() : module("Lookup", "lookup") {}
+lookup::lookup() : module("Lookup", "lookup") {
+  param(station_events_cache_ttl_, "station_events_cache_ttl",
+        "cache /lookup/station_events responses for this many seconds "
+        "(0 = disabled)");
+}
 lookup::~lookup() = default;
 
 void lookup::init(registry& r) {
@@ -32,35 +36,39 @@ void lookup::init(registry& r) {
 
   r.register_op("/lookup/geo_station_id",
                 [&](msg_ptr const& m) { return lookup_station_id(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
   r.register_op("/lookup/geo_station",
                 [&](msg_ptr const& m) { return lookup_station(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
   r.register_op("/lookup/geo_station_batch",
                 [&](msg_ptr const& m) { return lookup_stations(m); },
-                {kScheduleReadAccess});
-  r.register_op("/lookup/station_events",
-                [&](msg_ptr const& m) { return lookup_station_events(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
+  r.register_op(
+      "/lookup/station_events",
+      [&](msg_ptr const& m) { return lookup_station_events(m); },
+      {kScheduleReadAccess},
+      with_cache_ttl(kInteractiveOp,
+                     std::chrono::seconds{station_events_cache_ttl_}));
   r.register_op("/lookup/schedule_info",
                 [&](msg_ptr const&) { return lookup_schedule_info(); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
   r.register_op("/lookup/id_train",
                 [&](msg_ptr const& m) { return lookup_id_train(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
   r.register_op("/lookup/meta_station",
                 [&](msg_ptr const& m) { return lookup_meta_station(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
   r.register_op("/lookup/meta_station_batch",
                 [&](msg_ptr const& m) { return lookup_meta_stations(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
   r.register_op("/lookup/ribasis",
                 [&](msg_ptr const& m) { return lookup_ribasis(m); }, {});
   r.register_op("/lookup/station_info",
-                [&](msg_ptr const& m) { return lookup_station_info(m); }, {});
+                [&](msg_ptr const& m) { return lookup_station_info(m); }, {},
+                kInteractiveOp);
   r.register_op("/lookup/station_location",
                 [&](msg_ptr const& m) { return lookup_station_location(m); },
-                {kScheduleReadAccess});
+                {kScheduleReadAccess}, kInteractiveOp);
 }
 
 void lookup::import(motis::module::import_dispatcher& reg) {
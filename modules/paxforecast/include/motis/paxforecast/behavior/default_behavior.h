@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <random>
 
 #include "motis/paxforecast/behavior/probabilistic/passenger_behavior.h"
@@ -9,7 +10,12 @@ namespace motis::paxforecast::behavior {
 struct default_behavior {
   explicit default_behavior(bool deterministic_mode,
                             unsigned sample_count = 1000)
-      : rnd_gen_{get_seed()},
+      : default_behavior{deterministic_mode, std::nullopt, sample_count} {}
+
+  default_behavior(bool deterministic_mode,
+                   std::optional<std::mt19937::result_type> seed,
+                   unsigned sample_count = 1000)
+      : rnd_gen_{seed.has_value() ? seed.value() : get_seed()},
         pb_{rnd_gen_,
             sample_count,
             deterministic_mode,
@@ -46,6 +46,8 @@ struct paxforecast : public motis::module::module {
   duration min_delay_improvement_{5};
   bool revert_forecasts_{false};
   float probability_threshold_{0.01F};
+  bool parallel_simulation_{true};
+  unsigned simulation_seed_{0};
 
   bool allow_start_metas_{false};
   bool allow_dest_metas_{false};
@@ -3,8 +3,12 @@
 #include <cstdint>
 #include <algorithm>
 #include <map>
-#include <mutex>
+#include <numeric>
+#include <random>
 
+#include "cista/hashing.h"
+
+#include "utl/to_vec.h"
 #include "utl/zip.h"
 
 #include "motis/core/schedule/schedule.h"
@@ -50,39 +54,62 @@ inline void add_group_to_alternative(schedule const& sched,
 }
 
 struct sim_data {
-  explicit sim_data(simulation_result& result) : result_{result} {}
-
-  void finish_stats(std::uint64_t combined_group_count) {
-    result_.stats_.combined_group_count_ = combined_group_count;
-    result_.stats_.found_alt_count_avg_ = avg(found_alt_count_);
-    result_.stats_.picked_alt_count_avg_ = avg(picked_alt_count_);
-    result_.stats_.best_alt_prob_avg_ = avg(best_alt_prob_);
-    result_.stats_.second_alt_prob_avg_ = avg(second_alt_prob_);
+  void merge(sim_data const& o) {
+    auto const append = [](auto& target, auto const& source) {
+      target.insert(end(target), begin(source), end(source));
+    };
+    append(found_alt_count_, o.found_alt_count_);
+    append(picked_alt_count_, o.picked_alt_count_);
+    append(best_alt_prob_, o.best_alt_prob_);
+    append(second_alt_prob_, o.second_alt_prob_);
+  }
+
+  void finish_stats(simulation_result& result,
+                    std::uint64_t combined_group_count) const {
+    result.stats_.combined_group_count_ = combined_group_count;
+    result.stats_.found_alt_count_avg_ = avg(found_alt_count_);
+    result.stats_.picked_alt_count_avg_ = avg(picked_alt_count_);
+    result.stats_.best_alt_prob_avg_ = avg(best_alt_prob_);
+    result.stats_.second_alt_prob_avg_ = avg(second_alt_prob_);
   }
 
-  simulation_result& result_;
-  std::mutex result_mutex_;
   std::vector<std::uint8_t> found_alt_count_;
   std::vector<std::uint8_t> picked_alt_count_;
   std::vector<float> best_alt_prob_;
   std::vector<float> second_alt_prob_;
 };
 
+struct simulation_options {
+  float probability_threshold_{};
+  bool parallel_{true};
+  // seed for the passenger behavior rngs, 0 = random seed
+  std::uint64_t seed_{};
+};
+
+// simulation of a partition of the combined groups (e.g. all combined groups
+// with the same destination), results are merged after all partitions are
+// done
+struct sim_partition {
+  std::vector<combined_passenger_group const*> cpgs_;
+  std::mt19937::result_type seed_{};
+  simulation_result result_;
+  sim_data sd_;
+};
+
 template <typename PassengerBehavior>
 inline void simulate_behavior_for_cpg(schedule const& sched,
                                       motis::paxmon::universe& uv,
                                       PassengerBehavior& pb,
                                       combined_passenger_group const& cpg,
-                                      sim_data& sd,
+                                      simulation_result& result, sim_data& sd,
                                       float const probability_threshold) {
   if (cpg.group_routes_.empty()) {
     return;
   }
   auto const allocation = pb.pick_routes(cpg.alternatives_);
-  auto guard = std::lock_guard{sd.result_mutex_};
-  sd.result_.stats_.group_route_count_ += cpg.group_routes_.size();
+  result.stats_.group_route_count_ += cpg.group_routes_.size();
   for (auto const& pgwrap : cpg.group_routes_) {
-    auto& group_route_result = sd.result_.group_route_results_[pgwrap.pgwr_];
+    auto& group_route_result = result.group_route_results_[pgwrap.pgwr_];
     group_route_result.localization_ = &cpg.localization_;
     auto const new_probs = behavior::calc_new_probabilites(
         pgwrap.probability_, allocation, probability_threshold);
@@ -95,7 +122,7 @@ inline void simulate_behavior_for_cpg(schedule const& sched,
       group_route_result.alternative_probabilities_.emplace_back(&alt,
                                                                  probability);
       add_group_to_alternative(
-          sched, uv, sd.result_,
+          sched, uv, result,
           paxmon::additional_group{pgwrap.passengers_, probability}, alt);
       ++picked;
     }
@@ -119,39 +146,100 @@ inline void simulate_behavior_for_cpg(schedule const& sched,
   }
 }
 
-template <typename PassengerBehavior>
+// create_behavior(seed) must return an object with a pb_ member (see
+// behavior::default_behavior). each partition uses its own behavior instance
+// (and rng) seeded from the simulation seed and the partition index, the
+// result therefore only depends on the seed and not on the thread schedule.
+// all trips used by alternatives must already be in the graph.
+template <typename CreateBehavior>
+inline simulation_result simulate_partitions(
+    schedule const& sched, motis::paxmon::universe& uv,
+    std::vector<sim_partition>& partitions,
+    CreateBehavior const& create_behavior, simulation_options const& opt,
+    std::uint64_t const combined_group_count) {
+  auto const base_seed =
+      opt.seed_ != 0 ? opt.seed_
+                     : static_cast<std::uint64_t>(std::random_device{}());
+  for (auto i = 0ULL; i < partitions.size(); ++i) {
+    partitions[i].seed_ = static_cast<std::mt19937::result_type>(
+        cista::hash_combine(base_seed, i));
+  }
+
+  auto const simulate_partition = [&](sim_partition& p) {
+    auto b = create_behavior(p.seed_);
+    for (auto const* cpg : p.cpgs_) {
+      simulate_behavior_for_cpg(sched, uv, b.pb_, *cpg, p.result_, p.sd_,
+                                opt.probability_threshold_);
+    }
+  };
+
+  if (opt.parallel_) {
+    auto partition_indices = std::vector<std::size_t>(partitions.size());
+    std::iota(begin(partition_indices), end(partition_indices), 0U);
+    motis_parallel_for(partition_indices, [&](std::size_t const idx) {
+      simulate_partition(partitions[idx]);
+    });
+  } else {
+    for (auto& p : partitions) {
+      simulate_partition(p);
+    }
+  }
+
+  // merge in partition order to get a deterministic result
+  simulation_result result;
+  sim_data sd;
+  for (auto& p : partitions) {
+    for (auto& [e, groups] : p.result_.additional_groups_) {
+      auto& target = result.additional_groups_[e];
+      target.insert(end(target), begin(groups), end(groups));
+    }
+    for (auto& [pgwr, gsr] : p.result_.group_route_results_) {
+      auto& target = result.group_route_results_[pgwr];
+      target.localization_ = gsr.localization_;
+      target.alternative_probabilities_.insert(
+          end(target.alternative_probabilities_),
+          begin(gsr.alternative_probabilities_),
+          end(gsr.alternative_probabilities_));
+    }
+    result.stats_.group_route_count_ += p.result_.stats_.group_route_count_;
+    sd.merge(p.sd_);
+  }
+  sd.finish_stats(result, combined_group_count);
+  return result;
+}
+
+// partitioned by destination station
+template <typename CreateBehavior>
 inline simulation_result simulate_behavior(
     schedule const& sched, motis::paxmon::universe& uv,
     std::map<unsigned, std::vector<combined_passenger_group>> const&
         combined_groups,
-    PassengerBehavior& pb, float const probability_threshold) {
-  simulation_result result;
-  sim_data sd{result};
-  motis_parallel_for(combined_groups, ([&](auto const& cpgs) {
-                       for (auto const& cpg : cpgs.second) {
-                         simulate_behavior_for_cpg(sched, uv, pb, cpg, sd,
-                                                   probability_threshold);
-                       }
-                     }));
-  sd.finish_stats(combined_groups.size());
-  return result;
+    CreateBehavior const& create_behavior, simulation_options const& opt) {
+  auto partitions = std::vector<sim_partition>{};
+  partitions.reserve(combined_groups.size());
+  for (auto const& entry : combined_groups) {
+    partitions.emplace_back().cpgs_ =
+        utl::to_vec(entry.second, [](auto const& cpg) { return &cpg; });
+  }
+  return simulate_partitions(sched, uv, partitions, create_behavior, opt,
+                             combined_groups.size());
 }
 
-template <typename PassengerBehavior>
+// one partition per combined group
+template <typename CreateBehavior>
 inline simulation_result simulate_behavior(
     schedule const& sched, motis::paxmon::universe& uv,
     mcd::hash_map<mcd::pair<motis::paxmon::passenger_localization,
                             motis::paxmon::compact_journey>,
                   combined_passenger_group> const& combined_groups,
-    PassengerBehavior& pb, float const probability_threshold) {
-  simulation_result result;
-  sim_data sd{result};
-  motis_parallel_for(combined_groups, ([&](auto const& cpgs) {
-                       simulate_behavior_for_cpg(sched, uv, pb, cpgs.second, sd,
-                                                 probability_threshold);
-                     }));
-  sd.finish_stats(combined_groups.size());
-  return result;
+    CreateBehavior const& create_behavior, simulation_options const& opt) {
+  auto partitions = std::vector<sim_partition>{};
+  partitions.reserve(combined_groups.size());
+  for (auto const& entry : combined_groups) {
+    partitions.emplace_back().cpgs_.emplace_back(&entry.second);
+  }
+  return simulate_partitions(sched, uv, partitions, create_behavior, opt,
+                             combined_groups.size());
 }
 
 }  // namespace motis::paxforecast
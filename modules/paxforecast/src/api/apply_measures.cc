@@ -279,9 +279,13 @@ msg_ptr apply_measures(paxforecast& mod, paxmon_data& data,
     }
 
     manual_timer sim_timer{"passenger behavior simulation"};
-    auto pb = behavior::default_behavior{mod.deterministic_mode_};
-    auto const sim_result = simulate_behavior(sched, uv, combined, pb.pb_,
-                                              mod.probability_threshold_);
+    auto const sim_result = simulate_behavior(
+        sched, uv, combined,
+        [&](auto const seed) {
+          return behavior::default_behavior{mod.deterministic_mode_, seed};
+        },
+        simulation_options{mod.probability_threshold_,
+                           mod.parallel_simulation_, mod.simulation_seed_});
     sim_timer.stop_and_print();
     t_behavior_simulation += sim_timer.duration_ms();
 
@@ -373,9 +373,13 @@ void on_monitoring_update(paxforecast& mod, paxmon_data& data,
 
   MOTIS_START_TIMING(passenger_behavior);
   manual_timer sim_timer{"passenger behavior simulation"};
-  auto pb = behavior::default_behavior{mod.deterministic_mode_};
-  auto const sim_result = simulate_behavior(sched, uv, combined_groups, pb.pb_,
-                                            mod.probability_threshold_);
+  auto const sim_result = simulate_behavior(
+      sched, uv, combined_groups,
+      [&](auto const seed) {
+        return behavior::default_behavior{mod.deterministic_mode_, seed};
+      },
+      simulation_options{mod.probability_threshold_,
+                         mod.parallel_simulation_, mod.simulation_seed_});
   sim_timer.stop_and_print();
   MOTIS_STOP_TIMING(passenger_behavior);
   tick_stats.t_passenger_behavior_ = MOTIS_TIMING_MS(passenger_behavior);
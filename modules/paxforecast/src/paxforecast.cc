@@ -41,6 +41,11 @@ paxforecast::paxforecast() : module("Passenger Forecast", "paxforecast") {
   param(probability_threshold_, "probability_threshold",
         "minimum allowed route probability (routes with lower probability are "
         "dropped)");
+  param(parallel_simulation_, "parallel_simulation",
+        "simulate passenger behavior for different destinations in parallel");
+  param(simulation_seed_, "simulation_seed",
+        "rng seed for the passenger behavior simulation (0 = random seed, "
+        "results are reproducible for a fixed seed)");
   param(
       allow_start_metas_, "allow_start_metas",
       "allow using equivalent stations as start station in alternative routes");
@@ -108,7 +113,7 @@ void paxforecast::init(motis::module::registry& reg) {
                         to_res_id(global_res_id::PAX_DATA));
                     return api::apply_measures(*this, data, msg);
                   },
-                  {});
+                  {}, kBatchOp);
 
   reg.register_op("/paxforecast/metrics",
                   [&, this](msg_ptr const& msg) -> msg_ptr {
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include <map>
+#include <vector>
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/paxmon/universe.h"
+
+#include "motis/paxforecast/behavior/default_behavior.h"
+#include "motis/paxforecast/simulate_behavior.h"
+
+using namespace motis;
+using namespace motis::paxmon;
+using namespace motis::paxforecast;
+
+namespace {
+
+// alternatives without legs: the simulation does not touch the graph
+std::map<unsigned, std::vector<combined_passenger_group>> make_groups() {
+  auto groups = std::map<unsigned, std::vector<combined_passenger_group>>{};
+  auto pg = passenger_group_index{0U};
+  for (auto dest = 1U; dest <= 3U; ++dest) {
+    for (auto i = 0U; i < 2U; ++i) {
+      auto& cpg = groups[dest].emplace_back();
+      cpg.destination_station_id_ = dest;
+      for (auto r = 0U; r < 2U; ++r) {
+        cpg.group_routes_.emplace_back(
+            passenger_group_with_route_and_probability{
+                passenger_group_with_route{pg++, 0U}, 1.0F, 2U});
+        cpg.passengers_ += 2U;
+      }
+      for (auto a = 0U; a < 4U; ++a) {
+        auto& alt = cpg.alternatives_.emplace_back();
+        alt.duration_ = static_cast<duration>(60U + 5U * a + dest);
+        alt.transfers_ = a % 2U;
+        alt.is_original_ = a == 0U;
+      }
+    }
+  }
+  return groups;
+}
+
+simulation_result simulate(
+    schedule const& sched, universe& uv,
+    std::map<unsigned, std::vector<combined_passenger_group>> const& groups,
+    std::uint64_t const seed) {
+  return simulate_behavior(
+      sched, uv, groups,
+      [](auto const partition_seed) {
+        return behavior::default_behavior{false, partition_seed, 100U};
+      },
+      simulation_options{0.0F, false, seed});
+}
+
+}  // namespace
+
+TEST(paxforecast_simulate_behavior, fixed_seed_is_reproducible) {
+  schedule sched;
+  universe uv;
+  auto const groups = make_groups();
+
+  auto const a = simulate(sched, uv, groups, 42U);
+  auto const b = simulate(sched, uv, groups, 42U);
+
+  EXPECT_EQ(12U, a.stats_.group_route_count_);
+  EXPECT_EQ(a.stats_.group_route_count_, b.stats_.group_route_count_);
+  EXPECT_EQ(a.stats_.picked_alt_count_avg_, b.stats_.picked_alt_count_avg_);
+  EXPECT_EQ(a.stats_.best_alt_prob_avg_, b.stats_.best_alt_prob_avg_);
+  EXPECT_EQ(a.stats_.second_alt_prob_avg_, b.stats_.second_alt_prob_avg_);
+
+  ASSERT_EQ(12U, a.group_route_results_.size());
+  ASSERT_EQ(a.group_route_results_.size(), b.group_route_results_.size());
+  for (auto const& [pgwr, ra] : a.group_route_results_) {
+    auto const it = b.group_route_results_.find(pgwr);
+    ASSERT_NE(it, end(b.group_route_results_));
+    auto const& rb = it->second;
+    ASSERT_FALSE(ra.alternative_probabilities_.empty());
+    ASSERT_EQ(ra.alternative_probabilities_.size(),
+              rb.alternative_probabilities_.size());
+    for (auto i = 0U; i < ra.alternative_probabilities_.size(); ++i) {
+      EXPECT_EQ(ra.alternative_probabilities_[i].first,
+                rb.alternative_probabilities_[i].first);
+      EXPECT_EQ(ra.alternative_probabilities_[i].second,
+                rb.alternative_probabilities_[i].second);
+    }
+  }
+}
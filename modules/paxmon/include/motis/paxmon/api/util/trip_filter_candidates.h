@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "utl/erase_duplicates.h"
+
+#include "motis/core/schedule/connection.h"
+#include "motis/core/schedule/time.h"
+
+#include "motis/paxmon/trip_data_container.h"
+
+#include "motis/protocol/PaxMonFilterTripsTimeFilter_generated.h"
+
+namespace motis::paxmon::api {
+
+// returns the (sorted) trip data indices of all trips that may match the
+// given filters using the most selective trip filter index, the filters
+// still have to be applied to each returned trip
+inline std::vector<trip_data_index> get_trip_filter_candidates(
+    trip_data_container const& td, PaxMonFilterTripsTimeFilter const filter,
+    time const filter_interval_begin, time const filter_interval_end,
+    std::vector<std::uint32_t> const* train_nrs,
+    std::vector<service_class> const* service_classes) {
+  auto const& idx = td.filter_index_;
+  auto candidates = std::vector<trip_data_index>{};
+  auto const add = [&](trip_data_index const tdi) {
+    candidates.emplace_back(tdi);
+  };
+
+  if (train_nrs != nullptr) {
+    for (auto const train_nr : *train_nrs) {
+      idx.for_each_trip_with_train_nr(train_nr, add);
+    }
+    utl::erase_duplicates(candidates);
+  } else if (filter != PaxMonFilterTripsTimeFilter_NoFilter) {
+    idx.for_each_trip_active_in(filter_interval_begin, filter_interval_end,
+                                add);
+    std::sort(begin(candidates), end(candidates));
+  } else if (service_classes != nullptr) {
+    for (auto const clasz : *service_classes) {
+      idx.for_each_trip_with_class(clasz, add);
+    }
+    utl::erase_duplicates(candidates);
+  } else {
+    candidates.resize(td.size());
+    std::iota(begin(candidates), end(candidates), trip_data_index{0});
+  }
+
+  return candidates;
+}
+
+}  // namespace motis::paxmon::api
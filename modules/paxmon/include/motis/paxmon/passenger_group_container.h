@@ -6,6 +6,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "cista/hashing.h"
+
 #include "utl/erase.h"
 #include "utl/verify.h"
 
@@ -174,7 +176,7 @@ struct passenger_group_container {
 
       for (auto const& gr : group_routes_.at(pgi)) {
         route_edges_.at(gr.edges_index_).clear();
-        compact_journey_legs_.at(gr.compact_journey_index_).clear();
+        release_journey(gr.compact_journey_index_);
       }
       group_routes_.at(pgi).clear();
 
@@ -242,6 +244,59 @@ struct passenger_group_container {
     return fws_compact_journey{compact_journey_legs_.at(cji), final_footpaths_};
   }
 
+  // identical compact journeys (usually many groups travel on the same
+  // route) are only stored once and shared between group routes
+  template <typename Journey>
+  fws_compact_journey add_journey(Journey const& cj) {
+    auto& candidates = journeys_by_hash_[cj.hash()];
+    for (auto const cji : candidates) {
+      if (auto const existing = journey(cji); existing == cj) {
+        ++journey_ref_counts_[cji];
+        return existing;
+      }
+    }
+    auto const fws_cj =
+        to_fws_compact_journey(compact_journey_legs_, final_footpaths_, cj);
+    candidates.emplace_back(fws_cj.index());
+    journey_ref_counts_.emplace_back(1U);
+    utl::verify(journey_ref_counts_.size() == fws_cj.index() + 1,
+                "passenger_group_container: journey_ref_counts out of sync");
+    return fws_cj;
+  }
+
+  inline void release_journey(compact_journey_index const cji) {
+    auto& ref_count = journey_ref_counts_.at(cji);
+    utl::verify(ref_count != 0,
+                "passenger_group_container: journey released twice");
+    if (--ref_count != 0) {
+      return;
+    }
+    if (auto it = journeys_by_hash_.find(journey(cji).hash());
+        it != journeys_by_hash_.end()) {
+      utl::erase(it->second, cji);
+      if (it->second.empty()) {
+        journeys_by_hash_.erase(it);
+      }
+    }
+    compact_journey_legs_.at(cji).clear();
+  }
+
+  std::size_t allocated_size() const {
+    return allocator_.bytes_allocated() +
+           groups_.capacity() * sizeof(group_pointer) +
+           group_routes_.allocated_size() +
+           compact_journey_legs_.allocated_size() +
+           final_footpaths_.allocated_size_ * sizeof(final_footpath) +
+           journey_ref_counts_.allocated_size_ * sizeof(std::uint32_t) +
+           journeys_by_hash_.size() *
+               (sizeof(cista::hash_t) +
+                sizeof(mcd::vector<compact_journey_index>) +
+                sizeof(compact_journey_index)) +
+           route_edges_.allocated_size() +
+           reroute_log_entries_.allocated_size() +
+           log_entry_new_routes_.allocated_size();
+  }
+
   auto routes(passenger_group_index const pgi) const {
     return group_routes_.at(pgi);
   }
@@ -285,6 +340,11 @@ struct passenger_group_container {
   // index: compact_journey_index
   dynamic_fws_multimap<journey_leg> compact_journey_legs_;
   mcd::vector<final_footpath> final_footpaths_;
+  mcd::vector<std::uint32_t> journey_ref_counts_;
+
+  // compact journey hash -> compact journeys with that hash
+  mcd::hash_map<cista::hash_t, mcd::vector<compact_journey_index>>
+      journeys_by_hash_;
 
   // index: group_route_edges_index
   dynamic_fws_multimap<edge_index> route_edges_;
@@ -13,6 +13,7 @@
 #include "motis/paxmon/loader/loader_result.h"
 #include "motis/paxmon/paxmon_data.h"
 #include "motis/paxmon/settings/journey_input_settings.h"
+#include "motis/paxmon/snapshot.h"
 #include "motis/paxmon/statistics.h"
 #include "motis/paxmon/stats_writer.h"
 #include "motis/paxmon/universe.h"
@@ -40,6 +41,8 @@ private:
   loader::loader_result load_journeys(std::string const& file);
   void find_journey_files();
   void load_capacity_files();
+  bool restore_journeys_snapshot();
+  void write_journeys_snapshot();
   motis::module::msg_ptr rt_update(motis::module::msg_ptr const& msg);
   void rt_updates_applied(motis::module::msg_ptr const& msg);
   void rt_updates_applied(universe& uv, schedule const& sched);
@@ -72,6 +75,9 @@ private:
   bool graph_log_enabled_{false};
   int capacity_fuzzy_match_max_time_diff_{60};  // minutes
   std::uint16_t min_capacity_{0};
+  std::string snapshot_file_{};
+
+  snapshot_key snapshot_key_{};
 
   paxmon_data data_;
   std::unique_ptr<stats_writer> stats_writer_;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "cista/hashing.h"
+#include "cista/reflection/comparable.h"
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/paxmon/passenger_group.h"
+#include "motis/paxmon/settings/journey_input_settings.h"
+#include "motis/paxmon/temp_passenger_group.h"
+#include "motis/paxmon/universe.h"
+
+namespace motis::paxmon {
+
+// identifies the inputs a snapshot was created from - a snapshot is only
+// restored if the schedule and all journey/capacity input files are unchanged
+struct snapshot_key {
+  CISTA_COMPARABLE()
+
+  cista::hash_t schedule_hash_{};
+  cista::hash_t input_hash_{};
+};
+
+snapshot_key get_snapshot_key(
+    schedule const& sched, std::vector<std::string> const& journey_files,
+    std::vector<std::string> const& capacity_files,
+    settings::journey_input_settings const& journey_input_settings);
+
+struct snapshot_restore_result {
+  bool restored_{};
+  std::size_t groups_{};
+  std::size_t routes_{};
+};
+
+struct snapshot_group_route {
+  temp_group_route route_;
+  bool disabled_{};
+};
+
+// a passenger group as stored in a snapshot, routes in local route order
+struct snapshot_passenger_group {
+  data_source source_{};
+  std::uint16_t passengers_{};
+  std::vector<snapshot_group_route> routes_;
+};
+
+void write_snapshot_groups(std::string const& path, snapshot_key const& key,
+                           std::vector<snapshot_passenger_group> const&);
+
+// nullopt if the file is missing, invalid or was written for another key
+std::optional<std::vector<snapshot_passenger_group>> read_snapshot_groups(
+    std::string const& path, snapshot_key const& key);
+
+// Writes the passenger groups (incl. all group routes) of the universe.
+// Only valid before any real-time update or forecast changed the groups:
+// a snapshot must not contain routes over real-time trips or alternatives,
+// they are added again by the RIS replay after the restore.
+void write_snapshot(std::string const& path, universe const& uv,
+                    snapshot_key const& key);
+
+// adds all passenger groups stored in the snapshot to the (empty) universe,
+// the graph is rebuilt from the stored compact journeys
+snapshot_restore_result restore_snapshot(std::string const& path,
+                                         universe& uv, schedule const& sched,
+                                         snapshot_key const& key);
+
+}  // namespace motis::paxmon
@@ -47,6 +47,10 @@ struct tick_statistics {
     broken_group_routes_ += rhs.broken_group_routes_;
     major_delay_group_routes_ += rhs.major_delay_group_routes_;
 
+    duplicate_interchange_edges_skipped_ +=
+        rhs.duplicate_interchange_edges_skipped_;
+    unchanged_interchange_edges_ += rhs.unchanged_interchange_edges_;
+
     t_reachability_ += rhs.t_reachability_;
     t_localization_ += rhs.t_localization_;
     t_update_load_ += rhs.t_update_load_;
@@ -87,6 +91,10 @@ struct tick_statistics {
   std::uint64_t broken_group_routes_{};
   std::uint64_t major_delay_group_routes_{};
 
+  // interchange edge checks
+  std::uint64_t duplicate_interchange_edges_skipped_{};
+  std::uint64_t unchanged_interchange_edges_{};
+
   // timing (ms)
   std::uint64_t t_reachability_{};
   std::uint64_t t_localization_{};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
 
 #include "cista/hashing.h"
@@ -18,7 +19,7 @@ struct transfer_info {
     return type_ == type::SAME_STATION || type_ == type::FOOTPATH;
   }
 
-  enum class type { SAME_STATION, FOOTPATH, MERGE, THROUGH };
+  enum class type : std::uint8_t { SAME_STATION, FOOTPATH, MERGE, THROUGH };
   duration duration_{};
   type type_{type::SAME_STATION};
 };
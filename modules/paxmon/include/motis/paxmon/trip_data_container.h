@@ -11,6 +11,7 @@
 
 #include "motis/paxmon/graph_index.h"
 #include "motis/paxmon/trip_capacity_status.h"
+#include "motis/paxmon/trip_filter_index.h"
 
 namespace motis::paxmon {
 
@@ -44,6 +45,7 @@ struct trip_data_container {
     utl::verify(capacity_status_.size() == idx,
                 "insert_trip: invalid capacity_status_ size");
     capacity_status_.resize(idx + 1);
+    trip_indices_.emplace_back(trip_idx);
     return idx;
   }
 
@@ -100,6 +102,10 @@ struct trip_data_container {
     return capacity_status_[tdi];
   }
 
+  trip_idx_t trip_idx(trip_data_index tdi) const {
+    return trip_indices_[tdi];
+  }
+
   std::uint32_t size() const { return mapping_.size(); }
 
   dynamic_fws_multimap<edge_index> edges_;
@@ -107,6 +113,8 @@ struct trip_data_container {
   mcd::vector<event_node_index> enter_exit_nodes_;
   mcd::vector<trip_capacity_status> capacity_status_;
   mcd::hash_map<trip_idx_t, trip_data_index> mapping_;
+  mcd::vector<trip_idx_t> trip_indices_;
+  trip_filter_index filter_index_;
 };
 
 }  // namespace motis::paxmon
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include "utl/erase.h"
+#include "utl/verify.h"
+
+#include "motis/hash_map.h"
+#include "motis/vector.h"
+
+#include "motis/core/schedule/connection.h"
+#include "motis/core/schedule/time.h"
+
+#include "motis/paxmon/graph_index.h"
+
+namespace motis::paxmon {
+
+// secondary indices over the trip data container used by the trip filter
+// apis, maintained when trips are added to the graph or rerouted
+struct trip_filter_index {
+  static constexpr auto const BUCKET_SIZE = 60U;  // minutes
+  static constexpr auto const NOT_INDEXED =
+      std::numeric_limits<std::uint32_t>::max();
+
+  // trips may be inserted in any order (trips reached through merged or
+  // through services are completed before the trip that reached them)
+  void insert(trip_data_index const tdi, std::uint32_t const train_nr,
+              time const dep, time const arr, service_class const clasz) {
+    if (first_bucket_.size() <= tdi) {
+      first_bucket_.resize(tdi + 1U, NOT_INDEXED);
+      clasz_.resize(tdi + 1U, service_class::OTHER);
+    }
+    utl::verify(first_bucket_[tdi] == NOT_INDEXED,
+                "trip_filter_index: trip already indexed");
+    auto const first_bucket = bucket(dep);
+    auto const last_bucket = bucket(std::max(dep, arr));
+    if (time_buckets_.size() <= last_bucket) {
+      time_buckets_.resize(last_bucket + 1);
+    }
+    for (auto b = first_bucket; b <= last_bucket; ++b) {
+      time_buckets_[b].emplace_back(tdi);
+    }
+    first_bucket_[tdi] = first_bucket;
+    by_train_nr_[train_nr].emplace_back(tdi);
+    clasz_[tdi] = clasz;
+    class_list(clasz).emplace_back(tdi);
+  }
+
+  void update_service_class(trip_data_index const tdi,
+                            service_class const clasz) {
+    auto& current = clasz_.at(tdi);
+    if (current != clasz) {
+      utl::erase(class_list(current), tdi);
+      class_list(clasz).emplace_back(tdi);
+      current = clasz;
+    }
+  }
+
+  // calls fn once for every trip whose [departure, arrival] interval could
+  // overlap the given interval (exact filtering is left to the caller)
+  template <typename Fn>
+  void for_each_trip_active_in(time const begin, time const end,
+                               Fn&& fn) const {
+    if (time_buckets_.empty() || end < begin) {
+      return;
+    }
+    auto const first_bucket = bucket(begin);
+    auto const last_bucket = std::min(
+        bucket(end), static_cast<std::uint32_t>(time_buckets_.size() - 1));
+    for (auto b = first_bucket; b <= last_bucket; ++b) {
+      for (auto const tdi : time_buckets_[b]) {
+        // trips spanning multiple buckets are only reported once
+        if (b == std::max(first_bucket, first_bucket_[tdi])) {
+          fn(tdi);
+        }
+      }
+    }
+  }
+
+  template <typename Fn>
+  void for_each_trip_with_train_nr(std::uint32_t const train_nr,
+                                   Fn&& fn) const {
+    if (auto const it = by_train_nr_.find(train_nr);
+        it != end(by_train_nr_)) {
+      for (auto const tdi : it->second) {
+        fn(tdi);
+      }
+    }
+  }
+
+  template <typename Fn>
+  void for_each_trip_with_class(service_class const clasz, Fn&& fn) const {
+    auto const idx = static_cast<service_class_t>(clasz);
+    if (idx < by_class_.size()) {
+      for (auto const tdi : by_class_[idx]) {
+        fn(tdi);
+      }
+    }
+  }
+
+  static std::uint32_t bucket(time const t) { return t / BUCKET_SIZE; }
+
+  mcd::vector<trip_data_index>& class_list(service_class const clasz) {
+    auto const idx = static_cast<service_class_t>(clasz);
+    if (by_class_.size() <= idx) {
+      by_class_.resize(idx + 1U);
+    }
+    return by_class_[idx];
+  }
+
+  // index: trip_data_index
+  mcd::vector<std::uint32_t> first_bucket_;
+  mcd::vector<service_class> clasz_;
+
+  // index: departure/arrival time / BUCKET_SIZE
+  mcd::vector<mcd::vector<trip_data_index>> time_buckets_;
+
+  mcd::hash_map<std::uint32_t, mcd::vector<trip_data_index>> by_train_nr_;
+
+  // index: service_class
+  mcd::vector<mcd::vector<trip_data_index>> by_class_;
+};
+
+}  // namespace motis::paxmon
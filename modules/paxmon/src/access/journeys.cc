@@ -4,8 +4,7 @@ namespace motis::paxmon {
 
 fws_compact_journey add_compact_journey(universe& uv,
                                         compact_journey const& cj) {
-  return to_fws_compact_journey(uv.passenger_groups_.compact_journey_legs_,
-                                uv.passenger_groups_.final_footpaths_, cj);
+  return uv.passenger_groups_.add_journey(cj);
 }
 
 }  // namespace motis::paxmon
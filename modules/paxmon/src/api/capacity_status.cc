@@ -15,6 +15,7 @@
 #include "motis/paxmon/get_universe.h"
 #include "motis/paxmon/messages.h"
 
+#include "motis/paxmon/api/util/trip_filter_candidates.h"
 #include "motis/paxmon/api/util/trip_time_filter.h"
 
 using namespace motis::module;
@@ -108,8 +109,12 @@ msg_ptr capacity_status(paxmon_data& data, msg_ptr const& msg) {
   auto all_trips = capacity_stats{};
   auto by_provider = mcd::hash_map<std::string_view, provider_stats>{};
 
-  for (auto const& [trp_idx, tdi] : uv.trip_data_.mapping_) {
-    auto const* trp = get_trip(sched, trp_idx);
+  auto const candidates = get_trip_filter_candidates(
+      uv.trip_data_, filter_by_time, filter_interval_begin, filter_interval_end,
+      nullptr, nullptr);
+
+  for (auto const tdi : candidates) {
+    auto const* trp = get_trip(sched, uv.trip_data_.trip_idx(tdi));
 
     if (time_filter_active &&
         !include_trip_based_on_time_filter(
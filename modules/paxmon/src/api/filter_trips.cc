@@ -13,6 +13,7 @@
 #include "motis/paxmon/get_universe.h"
 #include "motis/paxmon/messages.h"
 
+#include "motis/paxmon/api/util/trip_filter_candidates.h"
 #include "motis/paxmon/api/util/trip_time_filter.h"
 
 using namespace motis::module;
@@ -87,7 +88,13 @@ msg_ptr filter_trips(paxmon_data& data, msg_ptr const& msg) {
   auto total_critical_sections = 0ULL;
   std::vector<trip_info> selected_trips;
 
-  for (auto const& [trp_idx, tdi] : uv.trip_data_.mapping_) {
+  auto const candidates = get_trip_filter_candidates(
+      uv.trip_data_, filter_by_time, filter_interval_begin, filter_interval_end,
+      filter_by_train_nr ? &filter_train_nrs : nullptr,
+      filter_by_service_class ? &filter_service_classes : nullptr);
+
+  for (auto const tdi : candidates) {
+    auto const trp_idx = uv.trip_data_.trip_idx(tdi);
     auto ti = trip_info{.trip_idx_ = trp_idx, .tdi_ = tdi};
     auto const trip_edges = uv.trip_data_.edges(tdi);
     auto include = false;
@@ -76,6 +76,11 @@ struct rule_trip_adder {
     }
 
     update_trip_capacity_status(sched_, uv_, trp, tdi);
+    uv_.trip_data_.filter_index_.insert(
+        tdi, trp->id_.primary_.get_train_nr(), trp->id_.primary_.get_time(),
+        trp->id_.secondary_.target_time_,
+        trip_edges.empty() ? service_class::OTHER
+                           : trip_edges[0].get(uv_)->clasz_);
 
     return tdi;
   }
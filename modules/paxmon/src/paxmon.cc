@@ -62,6 +62,7 @@
 #include "motis/paxmon/print_stats.h"
 #include "motis/paxmon/rt_updates.h"
 #include "motis/paxmon/service_info.h"
+#include "motis/paxmon/snapshot.h"
 #include "motis/paxmon/tools/commands.h"
 
 namespace fs = std::filesystem;
@@ -133,6 +134,10 @@ paxmon::paxmon() : module("Passenger Monitoring", "paxmon"), data_{*this} {
   param(min_capacity_, "min_capacity",
         "minimum capacity override (if capacity data is available but lower "
         "than this value, the minimum is used)");
+  param(snapshot_file_, "snapshot",
+        "passenger group snapshot file, restored at startup instead of "
+        "loading the journey files if the schedule and all input files are "
+        "unchanged (empty to disable)");
 }
 
 paxmon::~paxmon() = default;
@@ -527,7 +532,8 @@ void paxmon::load_journeys() {
     return;
   }
 
-  {
+  auto const restored = restore_journeys_snapshot();
+  if (!restored) {
     std::unique_ptr<output::journey_converter> converter;
     if (reroute_unmatched_ && !initial_reroute_query_file_.empty()) {
       converter = std::make_unique<output::journey_converter>(
@@ -593,6 +599,35 @@ void paxmon::load_journeys() {
     utl::verify(check_graph_integrity(uv, sched),
                 "load_journeys: check_graph_integrity");
   }
+
+  // only the initial state: real-time updates and forecasts are replayed
+  // after a restore
+  if (!restored) {
+    write_journeys_snapshot();
+  }
+}
+
+bool paxmon::restore_journeys_snapshot() {
+  if (snapshot_file_.empty()) {
+    return false;
+  }
+  auto const& sched = get_sched();
+  snapshot_key_ = get_snapshot_key(sched, journey_files_, capacity_files_,
+                                   journey_input_settings_);
+  return restore_snapshot(snapshot_file_, primary_universe(), sched,
+                          snapshot_key_)
+      .restored_;
+}
+
+void paxmon::write_journeys_snapshot() {
+  if (snapshot_file_.empty()) {
+    return;
+  }
+  try {
+    write_snapshot(snapshot_file_, primary_universe(), snapshot_key_);
+  } catch (std::exception const& e) {
+    LOG(logging::error) << "paxmon: could not write snapshot: " << e.what();
+  }
 }
 
 void paxmon::find_journey_files() {
@@ -41,6 +41,17 @@ void print_allocator_stats(universe const& uv) {
       static_cast<double>(allocator.bytes_allocated()) / (1024.0 * 1024.0),
       allocator.free_list_size(), allocator.allocation_count(),
       allocator.release_count());
+  auto const& pgc = uv.passenger_groups_;
+  auto const group_bytes = pgc.allocated_size();
+  LOG(info) << fmt::format(
+      "passenger group storage: {:.2f} MiB, {:.1f} bytes per active group, "
+      "{:L} compact journeys ({:L} distinct), {:L} journey legs",
+      static_cast<double>(group_bytes) / (1024.0 * 1024.0),
+      pgc.active_groups() != 0 ? static_cast<double>(group_bytes) /
+                                     static_cast<double>(pgc.active_groups())
+                               : 0.0,
+      pgc.compact_journey_legs_.index_size(), pgc.journeys_by_hash_.size(),
+      pgc.compact_journey_legs_.element_count());
   LOG(info) << uv.pax_connection_info_.size() << " pax connection infos";
 }
 
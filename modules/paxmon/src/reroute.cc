@@ -349,6 +349,10 @@ void apply_reroute(universe& uv, schedule const& sched, trip const* trp,
       }
     }
   }
+  if (!edges.empty()) {
+    uv.trip_data_.filter_index_.update_service_class(
+        tdi, edges[0].get(uv)->clasz_);
+  }
   auto canceled_nodes = uv.trip_data_.canceled_nodes(tdi);
   for (auto const* n : removed_nodes) {
     canceled_nodes.emplace_back(n->index(uv));
@@ -1,5 +1,6 @@
 #include "motis/paxmon/rt_updates.h"
 
+#include <algorithm>
 #include <limits>
 #include <numeric>
 #include <set>
@@ -30,8 +31,20 @@ namespace motis::paxmon {
 
 void check_broken_interchanges(
     universe& uv, schedule const& sched,
-    std::vector<edge_index> const& updated_interchange_edges,
+    std::vector<edge_index>& updated_interchange_edges,
     int arrival_delay_threshold) {
+  // an interchange edge is added once for each updated event of a trip, only
+  // evaluate it once per update
+  std::sort(begin(updated_interchange_edges), end(updated_interchange_edges));
+  auto const unique_end = std::unique(begin(updated_interchange_edges),
+                                      end(updated_interchange_edges));
+  uv.tick_stats_.duplicate_interchange_edges_skipped_ +=
+      std::distance(unique_end, end(updated_interchange_edges));
+  updated_interchange_edges.erase(unique_end, end(updated_interchange_edges));
+
+  // the required transfer time is the same for all group routes using an
+  // interchange edge, so group routes only have to be touched if the edge
+  // state flips between feasible and infeasible (or for exit edges)
   std::set<edge*> broken_interchanges;
   for (auto& icei : updated_interchange_edges) {
     auto* ice = icei.get(uv);
@@ -47,6 +60,7 @@ void check_broken_interchanges(
          ic < ice->transfer_time()) ||
         (from->station_ == 0 && to->current_time() < to->schedule_time())) {
       if (ice->broken_) {
+        ++uv.tick_stats_.unchanged_interchange_edges_;
         continue;
       }
       ice->broken_ = true;
@@ -73,6 +87,8 @@ void check_broken_interchanges(
              uv.pax_connection_info_.broken_group_routes(ice->pci_)) {
           uv.rt_update_ctx_.group_routes_affected_by_last_update_.insert(pgwr);
         }
+      } else if (to->station_ != 0) {
+        ++uv.tick_stats_.unchanged_interchange_edges_;
       }
       if (to->station_ == 0) {
         // update delay + check for delayed arrival at destination
@@ -0,0 +1,298 @@
+#include "motis/paxmon/snapshot.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+#include "cista/mmap.h"
+#include "cista/serialization.h"
+
+#include "utl/verify.h"
+
+#include "motis/core/common/logging.h"
+#include "motis/vector.h"
+
+#include "motis/paxmon/access/groups.h"
+#include "motis/paxmon/temp_passenger_group.h"
+
+namespace fs = std::filesystem;
+using namespace motis::logging;
+
+namespace motis::paxmon {
+
+namespace {
+
+constexpr auto const CISTA_MODE =
+    cista::mode::WITH_INTEGRITY | cista::mode::WITH_VERSION;
+
+constexpr auto const NO_TRANSFER = std::uint8_t{0xFF};
+
+// part of the key: version 1 snapshots could contain real-time state
+constexpr auto const SNAPSHOT_VERSION = std::uint64_t{2U};
+
+struct snapshot_leg {
+  trip_idx_t trip_idx_{};
+  std::uint32_t enter_station_id_{};
+  std::uint32_t exit_station_id_{};
+  motis::time enter_time_{};
+  motis::time exit_time_{};
+  duration transfer_duration_{};
+  std::uint8_t transfer_type_{NO_TRANSFER};
+};
+
+struct snapshot_route {
+  std::uint32_t legs_begin_{};
+  std::uint32_t legs_end_{};
+  duration ffp_duration_{};
+  std::uint32_t ffp_from_station_id_{};
+  std::uint32_t ffp_to_station_id_{};
+  float probability_{};
+  motis::time planned_arrival_time_{INVALID_TIME};
+  std::uint8_t source_flags_{};
+  bool planned_{};
+  bool disabled_{};
+};
+
+struct snapshot_group {
+  std::uint64_t primary_ref_{};
+  std::uint64_t secondary_ref_{};
+  std::uint16_t passengers_{};
+  std::uint32_t routes_begin_{};
+  std::uint32_t routes_end_{};
+};
+
+struct universe_snapshot {
+  cista::hash_t schedule_hash_{};
+  cista::hash_t input_hash_{};
+  mcd::vector<snapshot_group> groups_;
+  mcd::vector<snapshot_route> routes_;
+  mcd::vector<snapshot_leg> legs_;
+};
+
+cista::hash_t file_hash(std::string const& path) {
+  if (!fs::is_regular_file(path)) {
+    return cista::BASE_HASH;
+  }
+  auto hash = cista::hash(std::string_view{path});
+  cista::mmap m{path.c_str(), cista::mmap::protection::READ};
+  hash = cista::hash(
+      std::string_view{
+          reinterpret_cast<char const*>(m.begin()),
+          std::min(static_cast<size_t>(50 * 1024 * 1024), m.size())},
+      hash);
+  // the content is only sampled: the modification time catches changes
+  // beyond the first 50 MB that keep the file size
+  auto ec = std::error_code{};
+  auto const mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+  hash = cista::hash_combine(hash, m.size(), static_cast<std::int64_t>(mtime));
+  return hash;
+}
+
+}  // namespace
+
+snapshot_key get_snapshot_key(
+    schedule const& sched, std::vector<std::string> const& journey_files,
+    std::vector<std::string> const& capacity_files,
+    settings::journey_input_settings const& journey_input_settings) {
+  auto h = cista::hash_combine(cista::BASE_HASH, SNAPSHOT_VERSION);
+  for (auto const& f : journey_files) {
+    h = cista::hash_combine(h, file_hash(f));
+  }
+  for (auto const& f : capacity_files) {
+    h = cista::hash_combine(h, file_hash(f));
+  }
+  auto const& s = journey_input_settings;
+  h = cista::hash_combine(
+      cista::hash(std::string_view{s.journey_timezone_}, h),
+      s.match_tolerance_, s.split_groups_,
+      static_cast<std::uint64_t>(s.split_groups_size_mean_ * 1000.0),
+      static_cast<std::uint64_t>(s.split_groups_size_stddev_ * 1000.0),
+      s.split_groups_seed_, s.max_station_wait_time_);
+  return snapshot_key{sched.hash_, h};
+}
+
+void write_snapshot_groups(
+    std::string const& path, snapshot_key const& key,
+    std::vector<snapshot_passenger_group> const& groups) {
+  universe_snapshot snapshot;
+  snapshot.schedule_hash_ = key.schedule_hash_;
+  snapshot.input_hash_ = key.input_hash_;
+  snapshot.groups_.reserve(groups.size());
+
+  for (auto const& g : groups) {
+    auto const routes_begin =
+        static_cast<std::uint32_t>(snapshot.routes_.size());
+    for (auto const& [gr, disabled] : g.routes_) {
+      auto const legs_begin =
+          static_cast<std::uint32_t>(snapshot.legs_.size());
+      for (auto const& leg : gr.journey_.legs()) {
+        snapshot.legs_.emplace_back(snapshot_leg{
+            leg.trip_idx_, leg.enter_station_id_, leg.exit_station_id_,
+            leg.enter_time_, leg.exit_time_,
+            get_transfer_duration(leg.enter_transfer_),
+            leg.enter_transfer_.has_value()
+                ? static_cast<std::uint8_t>(leg.enter_transfer_->type_)
+                : NO_TRANSFER});
+      }
+      auto const& ffp = gr.journey_.final_footpath();
+      snapshot.routes_.emplace_back(snapshot_route{
+          legs_begin, static_cast<std::uint32_t>(snapshot.legs_.size()),
+          ffp.duration_, ffp.from_station_id_, ffp.to_station_id_,
+          gr.probability_, gr.planned_arrival_time_,
+          static_cast<std::uint8_t>(gr.source_flags_), gr.planned_, disabled});
+    }
+    snapshot.groups_.emplace_back(snapshot_group{
+        g.source_.primary_ref_, g.source_.secondary_ref_, g.passengers_,
+        routes_begin, static_cast<std::uint32_t>(snapshot.routes_.size())});
+  }
+
+  // write to a temporary file first, a crash while writing must not leave a
+  // broken snapshot behind
+  auto const tmp_path = path + ".tmp";
+  {
+    auto writer = cista::buf<cista::mmap>(
+        cista::mmap{tmp_path.c_str(), cista::mmap::protection::WRITE});
+    cista::serialize<CISTA_MODE>(writer, snapshot);
+  }
+  fs::rename(tmp_path, path);
+
+  LOG(info) << "paxmon: snapshot written: " << snapshot.groups_.size()
+            << " groups, " << snapshot.routes_.size() << " routes, "
+            << snapshot.legs_.size() << " legs";
+}
+
+std::optional<std::vector<snapshot_passenger_group>> read_snapshot_groups(
+    std::string const& path, snapshot_key const& key) {
+  if (!fs::is_regular_file(path)) {
+    return std::nullopt;
+  }
+
+  cista::memory_holder mem;
+  universe_snapshot const* snapshot = nullptr;
+  try {
+#if defined(MOTIS_SCHEDULE_MODE_OFFSET) && !defined(CLANG_TIDY)
+    mem = cista::buf<cista::mmap>(
+        cista::mmap{path.c_str(), cista::mmap::protection::READ});
+    snapshot = cista::deserialize<universe_snapshot, CISTA_MODE>(
+        std::get<cista::buf<cista::mmap>>(mem));
+#elif defined(MOTIS_SCHEDULE_MODE_RAW) || defined(CLANG_TIDY)
+    mem = cista::file(path.c_str(), "r").content();
+    // NOLINTNEXTLINE
+    snapshot = cista::deserialize<universe_snapshot, CISTA_MODE>(
+        std::get<cista::buffer>(mem));
+#else
+#error "no ptr mode specified"
+#endif
+  } catch (std::exception const& e) {
+    LOG(warn) << "paxmon: invalid snapshot " << path << ": " << e.what();
+    return std::nullopt;
+  }
+
+  if (snapshot->schedule_hash_ != key.schedule_hash_ ||
+      snapshot->input_hash_ != key.input_hash_) {
+    LOG(info) << "paxmon: snapshot " << path
+              << " is outdated (schedule or input files changed)";
+    return std::nullopt;
+  }
+
+  auto groups = std::vector<snapshot_passenger_group>{};
+  groups.reserve(snapshot->groups_.size());
+  for (auto const& sg : snapshot->groups_) {
+    auto& g = groups.emplace_back(snapshot_passenger_group{
+        data_source{sg.primary_ref_, sg.secondary_ref_}, sg.passengers_, {}});
+    g.routes_.reserve(sg.routes_end_ - sg.routes_begin_);
+    for (auto ri = sg.routes_begin_; ri != sg.routes_end_; ++ri) {
+      auto const& sr = snapshot->routes_[ri];
+      auto& [tgr, disabled] = g.routes_.emplace_back();
+      disabled = sr.disabled_;
+      tgr.probability_ = sr.probability_;
+      tgr.planned_arrival_time_ = sr.planned_arrival_time_;
+      tgr.source_flags_ = static_cast<route_source_flags>(sr.source_flags_);
+      tgr.planned_ = sr.planned_;
+      tgr.journey_.final_footpath() = final_footpath{
+          sr.ffp_duration_, sr.ffp_from_station_id_, sr.ffp_to_station_id_};
+      auto& legs = tgr.journey_.legs();
+      legs.reserve(sr.legs_end_ - sr.legs_begin_);
+      for (auto li = sr.legs_begin_; li != sr.legs_end_; ++li) {
+        auto const& sl = snapshot->legs_[li];
+        auto& leg = legs.emplace_back(
+            journey_leg{sl.trip_idx_, sl.enter_station_id_, sl.exit_station_id_,
+                        sl.enter_time_, sl.exit_time_, std::nullopt});
+        if (sl.transfer_type_ != NO_TRANSFER) {
+          leg.enter_transfer_ = transfer_info{
+              sl.transfer_duration_,
+              static_cast<transfer_info::type>(sl.transfer_type_)};
+        }
+      }
+    }
+  }
+  return groups;
+}
+
+void write_snapshot(std::string const& path, universe const& uv,
+                    snapshot_key const& key) {
+  scoped_timer const timer{"paxmon: write snapshot"};
+  auto const& pgc = uv.passenger_groups_;
+
+  auto groups = std::vector<snapshot_passenger_group>{};
+  groups.reserve(pgc.active_groups());
+  for (auto const* pg : pgc) {
+    if (pg == nullptr) {
+      continue;
+    }
+    auto& g = groups.emplace_back(
+        snapshot_passenger_group{pg->source_, pg->passengers_, {}});
+    for (auto const& gr : pgc.routes(pg->id_)) {
+      auto& [tgr, disabled] = g.routes_.emplace_back();
+      disabled = gr.disabled_;
+      tgr.probability_ = gr.probability_;
+      tgr.planned_arrival_time_ = gr.planned_arrival_time_;
+      tgr.source_flags_ = gr.source_flags_;
+      tgr.planned_ = gr.planned_;
+      tgr.journey_ =
+          to_compact_journey(pgc.journey(gr.compact_journey_index_));
+    }
+  }
+
+  write_snapshot_groups(path, key, groups);
+}
+
+snapshot_restore_result restore_snapshot(std::string const& path,
+                                         universe& uv, schedule const& sched,
+                                         snapshot_key const& key) {
+  scoped_timer const timer{"paxmon: restore snapshot"};
+  utl::verify(uv.passenger_groups_.size() == 0,
+              "paxmon: snapshot can only be restored into an empty universe");
+
+  auto result = snapshot_restore_result{};
+  auto const groups = read_snapshot_groups(path, key);
+  if (!groups.has_value()) {
+    return result;
+  }
+
+  uv.passenger_groups_.reserve(groups->size());
+  for (auto const& g : *groups) {
+    auto* pg = uv.passenger_groups_.add(
+        make_passenger_group(g.source_, g.passengers_));
+    for (auto const& [tgr, disabled] : g.routes_) {
+      auto const res = add_group_route(uv, sched, pg->id_, tgr, false, false,
+                                       pci_log_reason_t::UNKNOWN);
+      if (disabled) {
+        // keep local route indices stable, but remove the route from the graph
+        remove_group_route(uv, sched, res.pgwr_, false,
+                           pci_log_reason_t::UNKNOWN);
+      }
+      ++result.routes_;
+    }
+    ++result.groups_;
+  }
+
+  result.restored_ = true;
+  LOG(info) << "paxmon: restored " << result.groups_ << " groups with "
+            << result.routes_ << " routes from snapshot " << path;
+  return result;
+}
+
+}  // namespace motis::paxmon
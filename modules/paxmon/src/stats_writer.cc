@@ -30,6 +30,9 @@ void stats_writer::write_header() {
        << "broken_group_routes"
        << "major_delay_group_routes"
        //
+       << "duplicate_interchange_edges_skipped"
+       << "unchanged_interchange_edges"
+       //
        << "t_reachability"
        << "t_localization"
        << "t_update_load"
@@ -56,6 +59,9 @@ void stats_writer::write_tick(const tick_statistics& ts) {
        << ts.broken_group_routes_
        << ts.major_delay_group_routes_
        //
+       << ts.duplicate_interchange_edges_skipped_
+       << ts.unchanged_interchange_edges_
+       //
        << ts.t_reachability_ << ts.t_localization_ << ts.t_update_load_
        << ts.t_fbs_events_ << ts.t_publish_
        << ts.t_rt_updates_applied_total_
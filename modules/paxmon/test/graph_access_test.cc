@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+#include "motis/loader/loader.h"
+#include "motis/test/schedule/invalid_realtime.h"
+
+#include "motis/paxmon/graph_access.h"
+#include "motis/paxmon/universe.h"
+
+using namespace motis;
+using namespace motis::paxmon;
+using motis::test::schedule::invalid_realtime::dataset_opt;
+
+namespace {
+
+bool has_merged_or_through_services(schedule const& sched,
+                                    universe const& uv) {
+  return std::any_of(
+      begin(uv.graph_.nodes_), end(uv.graph_.nodes_), [&](auto const& n) {
+        auto const edges = n.outgoing_edges(uv);
+        return std::any_of(begin(edges), end(edges), [&](auto const& e) {
+          return e.type() == edge_type::THROUGH ||
+                 (e.is_trip() && e.get_trips(sched).size() > 1);
+        });
+      });
+}
+
+}  // namespace
+
+// trips reached through merged or through services are added while the
+// trip that reached them is still being built
+TEST(paxmon_graph_access, add_trips_with_merged_and_through_services) {
+  auto const sched = loader::load_schedule(dataset_opt);
+  auto uv = universe{};
+
+  for (auto const& trp : sched->trip_mem_) {
+    auto const tdi = get_or_add_trip(*sched, uv, trp.get());
+    ASSERT_NE(INVALID_TRIP_DATA_INDEX, tdi);
+    EXPECT_EQ(tdi, uv.trip_data_.get_index(trp->trip_idx_));
+  }
+  ASSERT_TRUE(has_merged_or_through_services(*sched, uv));
+
+  auto const& idx = uv.trip_data_.filter_index_;
+  ASSERT_EQ(uv.trip_data_.size(), idx.first_bucket_.size());
+  for (auto const& trp : sched->trip_mem_) {
+    auto const tdi = uv.trip_data_.get_index(trp->trip_idx_);
+    EXPECT_NE(trip_filter_index::NOT_INDEXED, idx.first_bucket_[tdi]);
+
+    auto found = false;
+    idx.for_each_trip_with_train_nr(
+        trp->id_.primary_.get_train_nr(),
+        [&](trip_data_index const t) { found = found || t == tdi; });
+    EXPECT_TRUE(found);
+  }
+}
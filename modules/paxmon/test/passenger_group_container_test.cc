@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include "motis/paxmon/passenger_group_container.h"
+
+namespace motis::paxmon {
+
+namespace {
+
+compact_journey make_journey(trip_idx_t const trip_idx,
+                             motis::time const enter_time) {
+  return compact_journey{
+      {journey_leg{trip_idx, 1, 2, enter_time,
+                   static_cast<motis::time>(enter_time + 30), std::nullopt}},
+      final_footpath{}};
+}
+
+}  // namespace
+
+TEST(paxmon_passenger_group_container, shared_journeys) {
+  auto pgc = passenger_group_container{};
+
+  auto const a = pgc.add_journey(make_journey(1, 100)).index();
+  auto const b = pgc.add_journey(make_journey(1, 100)).index();
+  auto const c = pgc.add_journey(make_journey(2, 100)).index();
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(2U, pgc.compact_journey_legs_.element_count());
+
+  pgc.release_journey(a);
+  EXPECT_EQ(1U, pgc.journey(b).legs().size());
+
+  pgc.release_journey(b);
+  EXPECT_TRUE(pgc.journey(b).legs().empty());
+
+  auto const d = pgc.add_journey(make_journey(1, 100)).index();
+  EXPECT_NE(a, d);
+  EXPECT_TRUE(pgc.journey(d) == make_journey(1, 100));
+}
+
+}  // namespace motis::paxmon
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "motis/paxmon/snapshot.h"
+
+namespace fs = std::filesystem;
+
+namespace motis::paxmon {
+
+namespace {
+
+snapshot_group_route make_route(trip_idx_t const trip_idx,
+                                motis::time const enter_time,
+                                float const probability, bool const disabled) {
+  auto r = snapshot_group_route{};
+  r.disabled_ = disabled;
+  r.route_.probability_ = probability;
+  r.route_.planned_arrival_time_ = static_cast<motis::time>(enter_time + 60);
+  r.route_.source_flags_ = route_source_flags::MATCH_INEXACT_TIME;
+  r.route_.planned_ = !disabled;
+  r.route_.journey_ = compact_journey{
+      {journey_leg{trip_idx, 1, 2, enter_time,
+                   static_cast<motis::time>(enter_time + 30), std::nullopt},
+       journey_leg{trip_idx + 1, 2, 3,
+                   static_cast<motis::time>(enter_time + 35),
+                   static_cast<motis::time>(enter_time + 60),
+                   transfer_info{5, transfer_info::type::SAME_STATION}}},
+      final_footpath{3, 3, 4}};
+  return r;
+}
+
+}  // namespace
+
+TEST(paxmon_snapshot, write_read_round_trip) {
+  auto const path =
+      (fs::temp_directory_path() / "paxmon_snapshot_test.raw").string();
+  auto const key = snapshot_key{1U, 2U};
+
+  auto groups = std::vector<snapshot_passenger_group>{};
+  groups.emplace_back(snapshot_passenger_group{
+      data_source{10, 1}, 3,
+      {make_route(1, 100, 0.75F, false), make_route(5, 120, 0.25F, true)}});
+  groups.emplace_back(snapshot_passenger_group{data_source{11, 0}, 1, {}});
+
+  write_snapshot_groups(path, key, groups);
+
+  auto const restored = read_snapshot_groups(path, key);
+  ASSERT_TRUE(restored.has_value());
+  ASSERT_EQ(groups.size(), restored->size());
+  for (auto gi = 0U; gi != groups.size(); ++gi) {
+    auto const& a = groups[gi];
+    auto const& b = (*restored)[gi];
+    EXPECT_EQ(a.source_, b.source_);
+    EXPECT_EQ(a.passengers_, b.passengers_);
+    ASSERT_EQ(a.routes_.size(), b.routes_.size());
+    for (auto ri = 0U; ri != a.routes_.size(); ++ri) {
+      auto const& ra = a.routes_[ri];
+      auto const& rb = b.routes_[ri];
+      EXPECT_EQ(ra.disabled_, rb.disabled_);
+      EXPECT_EQ(ra.route_.probability_, rb.route_.probability_);
+      EXPECT_EQ(ra.route_.planned_arrival_time_,
+                rb.route_.planned_arrival_time_);
+      EXPECT_EQ(ra.route_.source_flags_, rb.route_.source_flags_);
+      EXPECT_EQ(ra.route_.planned_, rb.route_.planned_);
+      EXPECT_TRUE(ra.route_.journey_ == rb.route_.journey_);
+    }
+  }
+
+  // schedule or input files changed
+  EXPECT_FALSE(read_snapshot_groups(path, snapshot_key{1U, 3U}).has_value());
+  EXPECT_FALSE(read_snapshot_groups(path, snapshot_key{4U, 2U}).has_value());
+
+  fs::remove(path);
+  EXPECT_FALSE(read_snapshot_groups(path, key).has_value());
+}
+
+}  // namespace motis::paxmon
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "motis/paxmon/trip_filter_index.h"
+
+namespace motis::paxmon {
+
+namespace {
+
+std::vector<trip_data_index> active_in(trip_filter_index const& idx,
+                                       time const begin, time const end) {
+  auto result = std::vector<trip_data_index>{};
+  idx.for_each_trip_active_in(
+      begin, end, [&](trip_data_index const tdi) { result.push_back(tdi); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+}  // namespace
+
+TEST(paxmon_trip_filter_index, time_buckets) {
+  auto idx = trip_filter_index{};
+  idx.insert(0, 100, 10, 50, service_class::ICE);
+  idx.insert(1, 200, 70, 400, service_class::RE);
+  idx.insert(2, 300, 500, 510, service_class::RE);
+
+  EXPECT_EQ((std::vector<trip_data_index>{0}), active_in(idx, 0, 30));
+  EXPECT_EQ((std::vector<trip_data_index>{0, 1}), active_in(idx, 0, 100));
+  EXPECT_EQ((std::vector<trip_data_index>{1}), active_in(idx, 200, 300));
+  EXPECT_EQ((std::vector<trip_data_index>{1, 2}), active_in(idx, 200, 600));
+  EXPECT_TRUE(active_in(idx, 1000, 2000).empty());
+}
+
+TEST(paxmon_trip_filter_index, train_nr_and_class) {
+  auto idx = trip_filter_index{};
+  idx.insert(0, 100, 10, 50, service_class::ICE);
+  idx.insert(1, 200, 70, 400, service_class::RE);
+  idx.insert(2, 100, 500, 510, service_class::RE);
+
+  auto train_nr_100 = std::vector<trip_data_index>{};
+  idx.for_each_trip_with_train_nr(
+      100, [&](trip_data_index const tdi) { train_nr_100.push_back(tdi); });
+  EXPECT_EQ((std::vector<trip_data_index>{0, 2}), train_nr_100);
+
+  idx.update_service_class(2, service_class::ICE);
+  auto ice = std::vector<trip_data_index>{};
+  idx.for_each_trip_with_class(service_class::ICE,
+                               [&](trip_data_index const tdi) {
+                                 ice.push_back(tdi);
+                               });
+  EXPECT_EQ((std::vector<trip_data_index>{0, 2}), ice);
+
+  auto re = std::vector<trip_data_index>{};
+  idx.for_each_trip_with_class(
+      service_class::RE, [&](trip_data_index const tdi) { re.push_back(tdi); });
+  EXPECT_EQ((std::vector<trip_data_index>{1}), re);
+}
+
+TEST(paxmon_trip_filter_index, insert_out_of_order) {
+  auto idx = trip_filter_index{};
+  idx.insert(2, 300, 500, 510, service_class::RE);
+  idx.insert(0, 100, 10, 50, service_class::ICE);
+  idx.insert(1, 200, 70, 400, service_class::RE);
+
+  EXPECT_EQ((std::vector<trip_data_index>{0, 1}), active_in(idx, 0, 100));
+  EXPECT_EQ((std::vector<trip_data_index>{1, 2}), active_in(idx, 200, 600));
+  EXPECT_ANY_THROW(idx.insert(1, 200, 70, 400, service_class::RE));
+}
+
+}  // namespace motis::paxmon
@@ -9,8 +9,13 @@
 
 namespace motis::raptor {
 
-trip_count get_earliest_trip(raptor_timetable const& tt,
-                             raptor_route const& route,
+// first trip departing at the route stop not before the given arrival
+trip_count get_earliest_departing_trip(raptor_timetable const& tt,
+                                       route_id r_id,
+                                       stop_times_index r_stop_offset,
+                                       time arrival);
+
+trip_count get_earliest_trip(raptor_timetable const& tt, route_id r_id,
                              time const* prev_arrivals,
                              stop_times_index r_stop_offset);
 
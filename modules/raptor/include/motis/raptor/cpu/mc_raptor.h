@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "utl/erase_if.h"
+
+#include "motis/core/schedule/connection.h"
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/journey/journey.h"
+
+#include "motis/raptor/cpu/cpu_raptor.h"
+#include "motis/raptor/cpu/mark_store.h"
+#include "motis/raptor/raptor_query.h"
+#include "motis/raptor/raptor_statistics.h"
+#include "motis/raptor/raptor_timetable.h"
+#include "motis/raptor/reconstructor.h"
+
+namespace motis::raptor {
+
+// The additional McRAPTOR criterion (arrival time and transfers are always
+// optimized). ride() is the cost of riding to the stop of the given stop
+// times index from the previous stop of the trip.
+struct no_criterion {
+  using value_type = uint8_t;
+  static value_type ride(raptor_meta_info const&, stop_times_index) {
+    return 0U;
+  }
+  static void write(journey&, value_type) {}
+};
+
+struct price_criterion {
+  using value_type = uint16_t;
+  static value_type ride(raptor_meta_info const& meta_info,
+                         stop_times_index const sti) {
+    return meta_info.lcon_ptr_[sti]->full_con_->price_;
+  }
+  static void write(journey& j, value_type const price) { j.price_ = price; }
+};
+
+enum class mc_label_kind : uint8_t { START, RIDE, FOOT };
+
+// Multi-criteria RAPTOR (Delling, Pajor, Werneck: Round-Based Public Transit
+// Routing) with one bag of pareto optimal labels per stop. Labels point to
+// their predecessor, journeys are reconstructed by following these pointers.
+template <typename Criterion>
+struct mc_raptor_search {
+  using value_type = typename Criterion::value_type;
+  using label_idx = uint32_t;
+
+  struct label {
+    time arrival_;  // incl. transfer time after RIDE labels (like raptor)
+    raptor_round round_;
+    mc_label_kind kind_;
+    stop_id stop_;
+    label_idx parent_;
+    route_id route_;  // RIDE only
+    trip_count trip_;  // RIDE only
+    stop_offset exit_offset_;  // RIDE only
+    stop_id origin_;  // START only: station the start footpath begins at
+    value_type value_;
+  };
+
+  mc_raptor_search(raptor_meta_info const& meta_info,
+                   raptor_timetable const& tt)
+      : meta_info_{meta_info},
+        tt_{tt},
+        bags_(tt.stop_count()),
+        station_marks_(tt.stop_count()),
+        route_marks_(tt.route_count()) {}
+
+  void search(base_query const& q, time const source_time,
+              raptor_statistics& stats) {
+    for (auto& bag : bags_) {
+      bag.clear();
+    }
+    labels_.clear();
+    marked_.clear();
+    station_marks_.reset();
+    targets_ = get_targets(q);
+
+    init(q, source_time);
+
+    for (raptor_round k = 1; k < max_raptor_round; ++k) {
+      if (marked_.empty()) {
+        break;
+      }
+
+      for (auto const s_id : marked_) {
+        auto const& stop = tt_.stops_[s_id];
+        for (auto sri = stop.index_to_stop_routes_;
+             sri < stop.index_to_stop_routes_ + stop.route_count_; ++sri) {
+          route_marks_.mark(tt_.stop_routes_[sri]);
+        }
+      }
+      marked_.clear();
+      station_marks_.reset();
+
+      rides_.clear();
+      for (route_id r_id = 0; r_id < tt_.route_count(); ++r_id) {
+        if (route_marks_.marked(r_id)) {
+          scan_route(r_id, k);
+          ++stats.cpu_routes_scanned_;
+        }
+      }
+      route_marks_.reset();
+
+      relax_footpaths(k);
+    }
+  }
+
+  // pareto optimal labels at the target (or its meta stations)
+  std::vector<label_idx> get_target_labels() const {
+    std::vector<label_idx> result;
+    for (auto const t : targets_) {
+      for (auto const idx : bags_[t]) {
+        auto const& l = labels_[idx];
+        if (l.round_ == 0U) {
+          continue;
+        }
+        auto const dominated =
+            std::any_of(begin(result), end(result), [&](label_idx const o) {
+              return dominates_at_target(labels_[o], l);
+            });
+        if (!dominated) {
+          utl::erase_if(result, [&](label_idx const o) {
+            return dominates_at_target(l, labels_[o]);
+          });
+          result.push_back(idx);
+        }
+      }
+    }
+    return result;
+  }
+
+  label const& operator[](label_idx const idx) const { return labels_[idx]; }
+
+  intermediate_journey reconstruct(label_idx const idx, base_query const& q,
+                                   time const source_time) const {
+    auto const& target = labels_[idx];
+    auto ij = intermediate_journey{static_cast<transfers>(target.round_ - 1),
+                                   q.ontrip_, source_time};
+
+    auto last_departure = invalid<time>;
+    auto l = &target;
+    while (l->kind_ != mc_label_kind::START) {
+      auto const& parent = labels_[l->parent_];
+      if (l->kind_ == mc_label_kind::FOOT) {
+        ij.add_footpath(l->stop_, l->arrival_, last_departure,
+                        l->arrival_ - parent.arrival_, meta_info_);
+      } else {
+        last_departure = ij.add_route(parent.stop_, l->route_, l->trip_,
+                                      l->exit_offset_, meta_info_, tt_);
+      }
+      l = &parent;
+    }
+
+    if (l->origin_ == l->stop_) {
+      ij.add_start_station(l->stop_, meta_info_, last_departure);
+    } else {
+      // start footpath durations include the transfer time at the origin
+      auto const walk = static_cast<time>(l->arrival_ - source_time);
+      ij.add_footpath(l->stop_, last_departure, last_departure,
+                      walk - meta_info_.transfer_times_[l->origin_],
+                      meta_info_);
+      ij.add_start_station(l->origin_, meta_info_, last_departure - walk);
+    }
+
+    return ij;
+  }
+
+private:
+  struct route_label {
+    trip_count trip_;
+    value_type value_;
+    label_idx parent_;
+  };
+
+  static value_type add(value_type const a, value_type const b) {
+    return static_cast<value_type>(
+        std::min(static_cast<unsigned>(a) + static_cast<unsigned>(b),
+                 static_cast<unsigned>(max_value<value_type>)));
+  }
+
+  // labels of earlier rounds never have more transfers
+  static bool dominates(label const& a, label const& b) {
+    return a.round_ <= b.round_ && a.arrival_ <= b.arrival_ &&
+           a.value_ <= b.value_;
+  }
+
+  // trip arrivals include the transfer time, footpath arrivals do not
+  bool dominates_at_target(label const& a, label const& b) const {
+    return a.round_ <= b.round_ &&
+           get_real_arrival(a) <= get_real_arrival(b) && a.value_ <= b.value_;
+  }
+
+  std::vector<stop_id> get_targets(base_query const& q) const {
+    return q.use_dest_metas_ ? meta_info_.equivalent_stations_[q.target_]
+                             : std::vector<stop_id>{q.target_};
+  }
+
+  time get_real_arrival(label const& l) const {
+    return l.kind_ == mc_label_kind::RIDE
+               ? static_cast<time>(l.arrival_ -
+                                   meta_info_.transfer_times_[l.stop_])
+               : l.arrival_;
+  }
+
+  void init(base_query const& q, time const source_time) {
+    auto const add_start = [&](stop_id const s_id, stop_id const origin,
+                               time const offset) {
+      add_label(label{static_cast<time>(source_time + offset), 0U,
+                      mc_label_kind::START, s_id, invalid<label_idx>,
+                      invalid<route_id>, invalid<trip_count>,
+                      invalid<stop_offset>, origin, value_type{0U}});
+    };
+    auto const add_starts = [&](stop_id const origin) {
+      add_start(origin, origin, 0U);
+      if (q.use_start_footpaths_) {
+        for (auto const& f : meta_info_.initialization_footpaths_[origin]) {
+          add_start(f.to_, origin, f.duration_);
+        }
+      }
+    };
+
+    add_starts(q.source_);
+    if (q.use_start_metas_) {
+      for (auto const equi : meta_info_.equivalent_stations_[q.source_]) {
+        if (equi != q.source_) {
+          add_starts(equi);
+        }
+      }
+    }
+  }
+
+  bool add_label(label const& l) {
+    auto& bag = bags_[l.stop_];
+    if (std::any_of(begin(bag), end(bag), [&](label_idx const idx) {
+          return dominates(labels_[idx], l);
+        })) {
+      return false;
+    }
+
+    // target pruning: continuing the journey never arrives earlier
+    for (auto const t : targets_) {
+      for (auto const idx : bags_[t]) {
+        auto const& o = labels_[idx];
+        if (o.round_ != 0U && dominates_at_target(o, l)) {
+          return false;
+        }
+      }
+    }
+
+    auto const l_idx = static_cast<label_idx>(labels_.size());
+    labels_.push_back(l);
+    utl::erase_if(bag, [&](label_idx const idx) {
+      return dominates(l, labels_[idx]);
+    });
+    bag.push_back(l_idx);
+
+    if (!station_marks_.marked(l.stop_)) {
+      station_marks_.mark(l.stop_);
+      marked_.push_back(l.stop_);
+    }
+    if (l.kind_ == mc_label_kind::RIDE) {
+      rides_.push_back(l_idx);
+    }
+    return true;
+  }
+
+  void add_route_label(route_label const& rl) {
+    if (std::any_of(begin(route_bag_), end(route_bag_),
+                    [&](route_label const& o) {
+                      return o.trip_ <= rl.trip_ && o.value_ <= rl.value_;
+                    })) {
+      return;
+    }
+    utl::erase_if(route_bag_, [&](route_label const& o) {
+      return rl.trip_ <= o.trip_ && rl.value_ <= o.value_;
+    });
+    route_bag_.push_back(rl);
+  }
+
+  void scan_route(route_id const r_id, raptor_round const k) {
+    auto const& route = tt_.routes_[r_id];
+    route_bag_.clear();
+
+    for (stop_offset offset = 0; offset < route.stop_count_; ++offset) {
+      auto const s_id = tt_.route_stops_[route.index_to_route_stops_ + offset];
+
+      // ride from the previous stop and alight here
+      if (offset != 0U) {
+        for (auto& rl : route_bag_) {
+          auto const sti = route.index_to_stop_times_ +
+                           (rl.trip_ * route.stop_count_) + offset;
+          rl.value_ = add(rl.value_, Criterion::ride(meta_info_, sti));
+
+          auto const arrival = tt_.stop_times_[sti].arrival_;
+          if (valid(arrival)) {
+            add_label(label{arrival, k, mc_label_kind::RIDE, s_id, rl.parent_,
+                            r_id, rl.trip_, offset, invalid<stop_id>,
+                            rl.value_});
+          }
+        }
+      }
+
+      // the trips can not be boarded at the last stop
+      if (offset + 1U == route.stop_count_) {
+        break;
+      }
+
+      // board with the labels of the previous round
+      for (auto const idx : bags_[s_id]) {
+        auto const& l = labels_[idx];
+        if (l.round_ + 1U != k) {
+          continue;
+        }
+        auto const trip =
+            get_earliest_departing_trip(tt_, r_id, offset, l.arrival_);
+        if (valid(trip)) {
+          add_route_label(route_label{trip, l.value_, idx});
+        }
+      }
+    }
+  }
+
+  // footpaths are not chained: only relaxed from labels of a trip arrival
+  void relax_footpaths(raptor_round const k) {
+    for (auto const idx : rides_) {
+      auto const s_id = labels_[idx].stop_;
+      for (auto fi = tt_.stops_[s_id].index_to_transfers_;
+           fi < tt_.stops_[s_id + 1].index_to_transfers_; ++fi) {
+        auto const& fp = tt_.footpaths_[fi];
+        auto const& l = labels_[idx];
+        add_label(label{static_cast<time>(l.arrival_ + fp.duration_), k,
+                        mc_label_kind::FOOT, fp.to_, idx, invalid<route_id>,
+                        invalid<trip_count>, invalid<stop_offset>,
+                        invalid<stop_id>, l.value_});
+      }
+    }
+  }
+
+  raptor_meta_info const& meta_info_;
+  raptor_timetable const& tt_;
+
+  std::vector<label> labels_;
+  std::vector<std::vector<label_idx>> bags_;
+  std::vector<route_label> route_bag_;
+  std::vector<label_idx> rides_;
+  std::vector<stop_id> targets_;
+
+  std::vector<stop_id> marked_;
+  cpu_mark_store station_marks_;
+  cpu_mark_store route_marks_;
+};
+
+// McRAPTOR for /raptor_mc: SearchType_Default optimizes arrival time and
+// transfers, SearchType_DefaultPrice adds the price.
+std::vector<journey> mc_raptor(base_query const&, routing::SearchType,
+                               raptor_statistics&, schedule const&,
+                               raptor_meta_info const&,
+                               raptor_timetable const&);
+
+}  // namespace motis::raptor
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <unordered_map>
@@ -134,6 +135,27 @@ struct raptor_timetable {
 
   std::vector<stop_time> stop_times_;
   std::vector<stop_id> route_stops_;
+
+  // entries of stop_times_ (and route_departures_, lcon_ptr_) no longer used
+  // by any route after real-time updates, reclaimed by the next rebuild
+  std::size_t unused_stop_times_{0U};
+
+  // Departures of stop_times_ transposed per route: the departures of all
+  // trips at one route stop are contiguous and, since routes are FIFO,
+  // sorted. Index: index_to_stop_times_ + offset * trip_count_ + trip
+  std::vector<time> route_departures_;
+
+  // Trips of every route bucketed by the day of their departure at the
+  // first stop with valid departures (boarding may not be allowed at the
+  // first stop), day_count_ + 1 entries per route: entry d is the first trip
+  // departing on day d or later, the last entry is the trip count.
+  // Index: r_id * (day_count_ + 1) + day
+  std::vector<trip_count> route_day_trips_;
+  // per route: max. departure at a route stop after the departure at the
+  // stop the day buckets are built from
+  std::vector<time> route_departure_spans_;
+  uint16_t day_count_{0U};
+
   std::vector<route_id> stop_routes_;
 
   // Needed for the reconstruction
@@ -153,6 +175,12 @@ struct raptor_timetable {
   }
 };
 
+// Rebuilds the day buckets of all routes (from route_departures_).
+void build_route_days(raptor_timetable&);
+
+// Recomputes the day buckets of a route after its departures changed.
+void update_route_days(raptor_timetable&, route_id);
+
 struct raptor_meta_info {
   raptor_meta_info() = default;
   raptor_meta_info(raptor_meta_info const&) = delete;
@@ -183,6 +211,10 @@ struct raptor_meta_info {
   // #stop_times(trip) = #lcons(trip) + 1
   std::vector<light_connection const*> lcon_ptr_;
 
+  // the raptor routes of every expanded route of the schedule
+  // (more than one if a real-time update split the expanded route)
+  std::vector<std::vector<route_id>> expanded_route_routes_;
+
   // duration of the footpaths INCLUDE transfer time from the departure
   // station
   std::vector<std::vector<raptor_footpath>> initialization_footpaths_;
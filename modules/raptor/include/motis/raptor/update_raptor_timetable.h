@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/raptor/raptor_timetable.h"
+
+namespace motis::raptor {
+
+// share of stop times no longer used by any route (see
+// raptor_timetable::unused_stop_times_) that triggers a rebuild
+constexpr auto const kMaxUnusedStopTimesShare = 0.25;
+
+struct raptor_update_stats {
+  std::uint64_t updated_trips_{0U};  // patched in place
+  std::uint64_t rebuilt_routes_{0U};  // expanded routes rebuilt
+  std::uint64_t added_routes_{0U};  // raptor routes appended
+};
+
+// Stop times of one trip laid out like the trip in stop_times_ (arrivals
+// include the transfer time) and its light connections like in lcon_ptr_.
+struct raptor_trip_times {
+  std::vector<stop_time> stop_times_;
+  std::vector<light_connection const*> lcons_;
+};
+
+// Overwrites the stop times of a trip if the trip order of the route stays
+// FIFO (no overtaking at any stop). Returns false otherwise.
+bool update_trip_times(raptor_meta_info&, raptor_timetable&, route_id,
+                       trip_count, raptor_trip_times const&);
+
+// Replaces the trips of the given routes (all serving the given stops) with
+// the given trips. The trips are split into FIFO chains: the first chains
+// reuse the given routes, further chains are appended as new routes. Routes
+// without a chain keep their stops but no trips. Returns the routes used.
+std::vector<route_id> set_route_trips(raptor_meta_info&, raptor_timetable&,
+                                      std::vector<route_id> const& routes,
+                                      std::vector<stop_id> const& stops,
+                                      std::vector<raptor_trip_times> trips,
+                                      raptor_update_stats&);
+
+// Applies the current real-time state to the timetable: delayed trips are
+// patched in place, expanded routes whose trips changed (separated,
+// rerouted, added or removed trips) and delayed trips which overtake
+// others are rebuilt. Departure events of changed trips are added to the
+// meta info (outdated departure events are kept, they are harmless).
+//
+// Returns false if the timetable has to be rebuilt (stations added or more
+// than kMaxUnusedStopTimesShare of the stop times are no longer used).
+bool update_raptor_timetable(schedule const&, raptor_meta_info&,
+                             raptor_timetable&,
+                             std::vector<trip const*> const& delayed_trips,
+                             std::vector<uint32_t> const& expanded_routes,
+                             raptor_update_stats&);
+
+}  // namespace motis::raptor
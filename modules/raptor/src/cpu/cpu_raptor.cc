@@ -1,11 +1,54 @@
 #include "motis/raptor/cpu/cpu_raptor.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace motis::raptor {
 
-trip_count get_earliest_trip(raptor_timetable const& tt,
-                             raptor_route const& route,
+trip_count get_earliest_departing_trip(raptor_timetable const& tt,
+                                       route_id const r_id,
+                                       stop_times_index const r_stop_offset,
+                                       time const arrival) {
+  auto const& route = tt.routes_[r_id];
+
+  // departures of all trips at this stop, ascending
+  auto const column = tt.route_departures_.data() +
+                      route.index_to_stop_times_ +
+                      (r_stop_offset * route.trip_count_);
+
+  // Trips departing at the first (boarding) stop before the day of
+  // (arrival - departure span) depart here before the arrival, trips
+  // departing there after the day of the arrival depart here after the
+  // arrival: only the trips of the days in between are searched.
+  auto const days = tt.route_day_trips_.data() + (r_id * (tt.day_count_ + 1U));
+  auto const span = tt.route_departure_spans_[r_id];
+  auto const get_day = [&](unsigned const t) {
+    return std::min(t / MINUTES_A_DAY, static_cast<unsigned>(tt.day_count_));
+  };
+  auto const first =
+      column + days[get_day(arrival > span ? arrival - span : 0U)];
+  auto const last = column + days[get_day(arrival + MINUTES_A_DAY)];
+
+  // short ranges: a branch-free scan over one or two cache lines
+  // beats the unpredictable branches of the binary search
+  constexpr auto const linear_scan_trip_count = 32;
+  auto const it = std::distance(first, last) <= linear_scan_trip_count
+                      ? first + std::count_if(first, last,
+                                              [&](time const departure) {
+                                                return departure < arrival;
+                                              })
+                      : std::lower_bound(first, last, arrival);
+
+  // all trips after the searched days depart after the arrival
+  return it == column + route.trip_count_ || !valid(*it)
+             ? invalid<trip_count>
+             : static_cast<trip_count>(std::distance(column, it));
+}
+
+trip_count get_earliest_trip(raptor_timetable const& tt, route_id const r_id,
                              time const* const prev_arrivals,
                              stop_times_index const r_stop_offset) {
+  auto const& route = tt.routes_[r_id];
 
   stop_id const stop_id =
       tt.route_stops_[route.index_to_route_stops_ + r_stop_offset];
@@ -15,26 +58,8 @@ trip_count get_earliest_trip(raptor_timetable const& tt,
     return invalid<trip_count>;
   }
 
-  // get first defined earliest trip for the stop in the route
-  auto const first_trip_stop_idx = route.index_to_stop_times_ + r_stop_offset;
-  auto const last_trip_stop_idx =
-      first_trip_stop_idx + ((route.trip_count_ - 1) * route.stop_count_);
-
-  trip_count current_trip = 0;
-  for (auto stop_time_idx = first_trip_stop_idx;
-       stop_time_idx <= last_trip_stop_idx;
-       stop_time_idx += route.stop_count_) {
-
-    auto const stop_time = tt.stop_times_[stop_time_idx];
-    if (valid(stop_time.departure_) &&
-        prev_arrivals[stop_id] <= stop_time.departure_) {
-      return current_trip;
-    }
-
-    ++current_trip;
-  }
-
-  return invalid<trip_count>;
+  return get_earliest_departing_trip(tt, r_id, r_stop_offset,
+                                     prev_arrivals[stop_id]);
 }
 
 void init_arrivals(raptor_result& result, raptor_query const& q,
@@ -66,7 +91,7 @@ void update_route(raptor_timetable const& tt, route_id const r_id,
 
     if (!valid(earliest_trip_id)) {
       earliest_trip_id =
-          get_earliest_trip(tt, route, prev_arrivals, r_stop_offset);
+          get_earliest_trip(tt, r_id, prev_arrivals, r_stop_offset);
       continue;
     }
 
@@ -109,7 +134,7 @@ void update_route(raptor_timetable const& tt, route_id const r_id,
     if (previous_k_arrival <= stop_time.departure_) {
       earliest_trip_id =
           std::min(earliest_trip_id,
-                   get_earliest_trip(tt, route, prev_arrivals, r_stop_offset));
+                   get_earliest_trip(tt, r_id, prev_arrivals, r_stop_offset));
     }
   }
 }
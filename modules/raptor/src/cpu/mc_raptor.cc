@@ -0,0 +1,111 @@
+#include "motis/raptor/cpu/mc_raptor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#include "utl/erase_if.h"
+#include "utl/to_vec.h"
+
+#include "motis/core/common/timing.h"
+#include "motis/core/access/error.h"
+
+namespace motis::raptor {
+
+namespace {
+
+template <typename Criterion>
+std::vector<journey> run_mc_raptor(base_query const& q,
+                                   raptor_statistics& stats,
+                                   schedule const& sched,
+                                   raptor_meta_info const& meta_info,
+                                   raptor_timetable const& tt) {
+  using value_type = typename Criterion::value_type;
+
+  struct result {
+    intermediate_journey ij_;
+    value_type value_;
+
+    bool dominates(result const& o) const {
+      return ij_.get_departure() >= o.ij_.get_departure() &&
+             ij_.get_arrival() <= o.ij_.get_arrival() &&
+             ij_.transfers_ <= o.ij_.transfers_ && value_ <= o.value_;
+    }
+  };
+
+  mc_raptor_search<Criterion> search{meta_info, tt};
+  std::vector<result> results;
+
+  auto const run = [&](time const source_time) {
+    ++stats.raptor_queries_;
+
+    MOTIS_START_TIMING(raptor_time);
+    search.search(q, source_time, stats);
+    stats.raptor_time_ += MOTIS_GET_TIMING_MS(raptor_time);
+
+    MOTIS_START_TIMING(rec_time);
+    for (auto const idx : search.get_target_labels()) {
+      auto r = result{search.reconstruct(idx, q, source_time),
+                      search[idx].value_};
+      if (std::any_of(begin(results), end(results),
+                      [&](result const& o) { return o.dominates(r); })) {
+        continue;
+      }
+      utl::erase_if(results, [&](result const& o) { return r.dominates(o); });
+      results.emplace_back(std::move(r));
+    }
+    stats.rec_time_ += MOTIS_GET_TIMING_US(rec_time);
+  };
+
+  if (q.ontrip_) {
+    run(q.source_time_begin_);
+  } else {
+    // one search per departure in the interval, latest first
+    auto const& dep_events = q.use_start_metas_
+                                 ? meta_info.departure_events_with_metas_
+                                 : meta_info.departure_events_;
+    auto const& events = dep_events[q.source_];
+    auto const first = std::lower_bound(begin(events), end(events),
+                                        q.source_time_begin_);
+    auto const last =
+        std::upper_bound(first, end(events), q.source_time_end_);
+    for (auto it = last; it != first; --it) {
+      if (it == last || *std::prev(it) != *it) {
+        run(*std::prev(it));
+      }
+    }
+  }
+
+  utl::erase_if(results, [&](result const& r) {
+    return (!q.ontrip_ && r.ij_.get_departure() > q.source_time_end_) ||
+           r.ij_.get_duration() > max_travel_duration;
+  });
+  for (auto& r : results) {
+    r.ij_.finalize();
+  }
+  return utl::to_vec(results, [&](result const& r) {
+    auto j = r.ij_.to_journey(sched);
+    Criterion::write(j, r.value_);
+    return j;
+  });
+}
+
+}  // namespace
+
+std::vector<journey> mc_raptor(base_query const& q,
+                               routing::SearchType const search_type,
+                               raptor_statistics& stats,
+                               schedule const& sched,
+                               raptor_meta_info const& meta_info,
+                               raptor_timetable const& tt) {
+  switch (search_type) {
+    case routing::SearchType_Default:
+      return run_mc_raptor<no_criterion>(q, stats, sched, meta_info, tt);
+    case routing::SearchType_DefaultPrice:
+      return run_mc_raptor<price_criterion>(q, stats, sched, meta_info, tt);
+    default: throw std::system_error(access::error::not_implemented);
+  }
+}
+
+}  // namespace motis::raptor
@@ -1,10 +1,13 @@
 #include "motis/raptor/get_raptor_timetable.h"
 
+#include <algorithm>
+#include <iterator>
 #include <thread>
 #include <tuple>
 
 #include "utl/concat.h"
 #include "utl/erase_duplicates.h"
+#include "utl/verify.h"
 
 #include "motis/core/common/logging.h"
 #include "motis/core/access/station_access.h"
@@ -62,6 +65,7 @@ struct transformable_trip {
 struct transformable_route {
   std::vector<transformable_trip> trips_;
   std::vector<stop_id> route_stops_;
+  uint32_t expanded_route_{};
 };
 
 struct transformable_timetable {
@@ -143,6 +147,7 @@ void init_routes(schedule const& sched, std::vector<transformable_route>& rs) {
     }
     auto& t_route = rs[r_id];
 
+    t_route.expanded_route_ = route_trips.index();
     t_route.trips_.resize(route_trips.size());
 
     auto const& first_trip = route_trips[0];
@@ -279,6 +284,25 @@ std::unique_ptr<raptor_timetable> create_raptor_timetable(
     }
   }
 
+  tt->route_departures_.resize(tt->stop_times_.size());
+  for (auto r_id = 0U; r_id < tt->routes_.size(); ++r_id) {
+    auto const& route = tt->routes_[r_id];
+    for (auto offset = 0; offset < route.stop_count_; ++offset) {
+      auto const column = std::next(
+          begin(tt->route_departures_),
+          route.index_to_stop_times_ + (offset * route.trip_count_));
+      for (auto trip = 0; trip < route.trip_count_; ++trip) {
+        auto const sti =
+            route.index_to_stop_times_ + (trip * route.stop_count_) + offset;
+        *std::next(column, trip) = tt->stop_times_[sti].departure_;
+      }
+      utl::verify(std::is_sorted(column, std::next(column, route.trip_count_)),
+                  "raptor: departures of route {} not sorted", r_id);
+    }
+  }
+
+  build_route_days(*tt);
+
   return tt;
 }
 
@@ -384,13 +408,19 @@ std::unique_ptr<raptor_meta_info> transformable_to_meta_info(
   }
 
   // Loop over the routes
-  for (auto const& r : ttt.routes_) {
+  for (auto r_id = 0U; r_id < ttt.routes_.size(); ++r_id) {
+    auto const& r = ttt.routes_[r_id];
     for (auto const& t : r.trips_) {
       meta_info->lcon_ptr_.push_back(nullptr);
       for (auto const& rlc : t.lcons_) {
         meta_info->lcon_ptr_.push_back(rlc.lcon_);
       }
     }
+
+    if (meta_info->expanded_route_routes_.size() <= r.expanded_route_) {
+      meta_info->expanded_route_routes_.resize(r.expanded_route_ + 1U);
+    }
+    meta_info->expanded_route_routes_[r.expanded_route_].push_back(r_id);
   }
 
   return meta_info;
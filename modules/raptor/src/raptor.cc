@@ -1,24 +1,33 @@
 #include "motis/raptor/raptor.h"
 
+#include <system_error>
+
+#include "utl/erase_duplicates.h"
 #include "utl/to_vec.h"
 
 #include "motis/module/message.h"
 
+#include "motis/core/common/logging.h"
 #include "motis/core/common/timing.h"
 #include "motis/core/schedule/schedule.h"
 #include "motis/core/access/time_access.h"
+#include "motis/core/conv/trip_conv.h"
 #include "motis/core/journey/journey.h"
 #include "motis/core/journey/journey_util.h"
 #include "motis/core/journey/journeys_to_message.h"
 #include "motis/core/journey/message_to_journeys.h"
 #include "motis/module/event_collector.h"
 
+#include "motis/raptor/cpu/mc_raptor.h"
 #include "motis/raptor/get_raptor_timetable.h"
 #include "motis/raptor/raptor_query.h"
 #include "motis/raptor/raptor_search.h"
+#include "motis/raptor/update_raptor_timetable.h"
 
+using namespace motis::logging;
 using namespace motis::module;
 using namespace motis::routing;
+using namespace motis::rt;
 
 namespace motis::raptor {
 
@@ -77,8 +86,17 @@ struct raptor::impl {
 
   void init_timetable() {
     std::tie(meta_info_, timetable_) = get_raptor_timetable(sched_);
+    rt_trips_.clear();
+    rt_expanded_routes_.clear();
+    rebuild_required_ = false;
+    init_gpu_timetable();
+  }
 
+  void init_gpu_timetable() {
 #if defined(MOTIS_CUDA)
+    if (d_gtt_ != nullptr) {
+      destroy_device_gpu_timetable(*d_gtt_);
+    }
     h_gtt_ = get_host_gpu_timetable(*timetable_);
     d_gtt_ = get_device_gpu_timetable(*h_gtt_);
 
@@ -86,6 +104,79 @@ struct raptor::impl {
 #endif
   }
 
+  // collects the changed trips, they are applied once the graph is updated
+  void rt_update(msg_ptr const& msg) {
+    auto const update = motis_content(RtUpdates, msg);
+    if (update->schedule() != 0U || rebuild_required_) {
+      return;
+    }
+
+    try {
+      for (auto const& u : *update->updates()) {
+        if (u->intermediate()) {
+          continue;
+        }
+        switch (u->content_type()) {
+          case Content_RtDelayUpdate:
+            rt_trips_.emplace_back(from_fbs(
+                sched_,
+                reinterpret_cast<RtDelayUpdate const*>(u->content())->trip()));
+            break;
+          case Content_RtExpandedTripUpdate: {
+            auto const etu =
+                reinterpret_cast<RtExpandedTripUpdate const*>(u->content());
+            if (etu->update_type() != RtExpandedTripUpdateType_TripAdded) {
+              rt_expanded_routes_.emplace_back(
+                  etu->old_expanded_route()->route_index());
+            }
+            if (etu->update_type() != RtExpandedTripUpdateType_TripRemoved) {
+              rt_expanded_routes_.emplace_back(
+                  etu->new_expanded_route()->route_index());
+            }
+            break;
+          }
+          case Content_RtStationAdded: rebuild_required_ = true; break;
+          default: break;
+        }
+      }
+    } catch (std::system_error const& e) {
+      LOG(warn) << "raptor: trip of real-time update not found: " << e.what();
+      rebuild_required_ = true;
+    }
+  }
+
+  void rt_graph_updated(msg_ptr const& msg) {
+    if (motis_content(RtGraphUpdated, msg)->schedule() != 0U) {
+      return;
+    }
+    if (!rebuild_required_ && rt_trips_.empty() &&
+        rt_expanded_routes_.empty()) {
+      return;
+    }
+
+    MOTIS_START_TIMING(update_time);
+    utl::erase_duplicates(rt_trips_);
+    utl::erase_duplicates(rt_expanded_routes_);
+    raptor_update_stats stats;
+    if (rebuild_required_ ||
+        !update_raptor_timetable(sched_, *meta_info_, *timetable_, rt_trips_,
+                                 rt_expanded_routes_, stats)) {
+      LOG(info) << "raptor: real-time update not applicable or too much "
+                   "unused space, rebuilding";
+      init_timetable();
+      return;
+    }
+    init_gpu_timetable();
+    rt_trips_.clear();
+    rt_expanded_routes_.clear();
+
+    LOG(info) << "raptor: real-time update: " << stats.updated_trips_
+              << " trips updated, " << stats.rebuilt_routes_
+              << " routes rebuilt, " << stats.added_routes_
+              << " routes added (" << MOTIS_GET_TIMING_MS(update_time)
+              << "ms)";
+  }
+
   msg_ptr route_cpu(msg_ptr const& msg) {
     MOTIS_START_TIMING(total_calculation_time);
 
@@ -102,6 +193,21 @@ struct raptor::impl {
     return make_response(sched_, journeys, req, stats);
   }
 
+  msg_ptr route_mc_cpu(msg_ptr const& msg) {
+    MOTIS_START_TIMING(total_calculation_time);
+
+    auto const req = motis_content(RoutingRequest, msg);
+    auto const q = get_base_query(req, sched_, *meta_info_);
+
+    raptor_statistics stats;
+    auto const journeys =
+        mc_raptor(q, req->search_type(), stats, sched_, *meta_info_,
+                  *timetable_);
+    stats.total_calculation_time_ = MOTIS_GET_TIMING_MS(total_calculation_time);
+
+    return make_response(sched_, journeys, req, stats);
+  }
+
 #if defined(MOTIS_CUDA)
   msg_ptr route_gpu(msg_ptr const& msg) {
     raptor_statistics stats;
@@ -127,6 +233,10 @@ struct raptor::impl {
   std::unique_ptr<raptor_meta_info> meta_info_;
   std::unique_ptr<raptor_timetable> timetable_;
 
+  std::vector<trip const*> rt_trips_;
+  std::vector<uint32_t> rt_expanded_routes_;
+  bool rebuild_required_{false};
+
 #if defined(MOTIS_CUDA)
   std::unique_ptr<host_gpu_timetable> h_gtt_;
   std::unique_ptr<device_gpu_timetable> d_gtt_;
@@ -174,6 +284,10 @@ void raptor::init(motis::module::registry& reg) {
   reg.register_op("/raptor_cpu", [&](auto&& m) { return impl_->route_cpu(m); },
                   {kScheduleReadAccess});
 
+  reg.register_op("/raptor_mc",
+                  [&](auto&& m) { return impl_->route_mc_cpu(m); },
+                  {kScheduleReadAccess});
+
   reg.register_op(
       "/raptor/update_timetable",
       [&](auto&&) -> msg_ptr {
@@ -184,6 +298,26 @@ void raptor::init(motis::module::registry& reg) {
           to_res_id(::motis::module::global_res_id::SCHEDULE),
           ctx::access_t::WRITE}});
 
+  reg.subscribe(
+      "/rt/update",
+      [&](msg_ptr const& msg) -> msg_ptr {
+        impl_->rt_update(msg);
+        return nullptr;
+      },
+      ctx::accesses_t{ctx::access_request{
+          to_res_id(::motis::module::global_res_id::SCHEDULE),
+          ctx::access_t::WRITE}});
+
+  reg.subscribe(
+      "/rt/graph_updated",
+      [&](msg_ptr const& msg) -> msg_ptr {
+        impl_->rt_graph_updated(msg);
+        return nullptr;
+      },
+      ctx::accesses_t{ctx::access_request{
+          to_res_id(::motis::module::global_res_id::SCHEDULE),
+          ctx::access_t::WRITE}});
+
 #if defined(MOTIS_CUDA)
   reg.register_op("/raptor", [&](auto&& m) { return impl_->route_gpu(m); },
                   {kScheduleReadAccess});
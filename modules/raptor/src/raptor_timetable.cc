@@ -1,5 +1,8 @@
 #include "motis/raptor/raptor_timetable.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace motis::raptor {
 
 // overload invalid for station id,
@@ -7,4 +10,97 @@ namespace motis::raptor {
 template <>
 constexpr auto invalid<stop_id> = -1;
 
-}  // namespace motis::raptor
\ No newline at end of file
+namespace {
+
+// Departures of the first route stop with valid departures: boarding is not
+// necessarily allowed at the first stops of a route. The day buckets are
+// built from this stop (all stops before it have no valid departures).
+std::vector<time>::const_iterator get_first_departures(
+    raptor_timetable const& tt, raptor_route const& route) {
+  auto const first =
+      std::next(begin(tt.route_departures_), route.index_to_stop_times_);
+  for (auto offset = 0U; offset < route.stop_count_; ++offset) {
+    auto const column = std::next(first, offset * route.trip_count_);
+    if (std::any_of(column, std::next(column, route.trip_count_),
+                    [](time const departure) { return valid(departure); })) {
+      return column;
+    }
+  }
+  return first;
+}
+
+time get_last_first_departure(raptor_timetable const& tt,
+                              raptor_route const& route) {
+  auto const first = get_first_departures(tt, route);
+  auto last_departure = time{0U};
+  for (auto it = first; it != std::next(first, route.trip_count_); ++it) {
+    if (valid(*it)) {
+      last_departure = std::max(last_departure, *it);
+    }
+  }
+  return last_departure;
+}
+
+void set_route_days(raptor_timetable& tt, route_id const r_id) {
+  auto const& route = tt.routes_[r_id];
+  auto const first = get_first_departures(tt, route);
+  auto const last = std::next(first, route.trip_count_);
+
+  auto const days = std::next(begin(tt.route_day_trips_),
+                              r_id * (tt.day_count_ + 1U));
+  for (auto day = 0U; day < tt.day_count_; ++day) {
+    auto const day_begin = day * MINUTES_A_DAY;
+    *std::next(days, day) = static_cast<trip_count>(
+        std::distance(first, std::lower_bound(first, last, day_begin)));
+  }
+  *std::next(days, tt.day_count_) = route.trip_count_;
+
+  auto span = time{0U};
+  auto const stop_times_end = std::next(
+      begin(tt.route_departures_),
+      route.index_to_stop_times_ + route.stop_count_ * route.trip_count_);
+  for (auto column = last; column != stop_times_end;
+       std::advance(column, route.trip_count_)) {
+    for (auto trip = 0U; trip < route.trip_count_; ++trip) {
+      auto const departure = *std::next(column, trip);
+      auto const first_departure = *std::next(first, trip);
+      if (valid(departure) && valid(first_departure)) {
+        span = std::max(span, static_cast<time>(departure - first_departure));
+      }
+    }
+  }
+  tt.route_departure_spans_[r_id] = span;
+}
+
+}  // namespace
+
+void build_route_days(raptor_timetable& tt) {
+  auto last_departure = time{0U};
+  for (auto const& route : tt.routes_) {
+    last_departure =
+        std::max(last_departure, get_last_first_departure(tt, route));
+  }
+
+  tt.day_count_ = static_cast<uint16_t>(last_departure / MINUTES_A_DAY + 1U);
+  tt.route_day_trips_.resize(tt.routes_.size() * (tt.day_count_ + 1U));
+  tt.route_departure_spans_.resize(tt.routes_.size());
+  for (auto r_id = route_id{0U}; r_id < tt.routes_.size(); ++r_id) {
+    set_route_days(tt, r_id);
+  }
+}
+
+void update_route_days(raptor_timetable& tt, route_id const r_id) {
+  // delayed beyond the last day: the bucket layout changes
+  if (get_last_first_departure(tt, tt.routes_[r_id]) / MINUTES_A_DAY >=
+      tt.day_count_) {
+    build_route_days(tt);
+    return;
+  }
+
+  // routes added since the last call have no buckets yet
+  tt.route_day_trips_.resize(tt.routes_.size() * (tt.day_count_ + 1U));
+  tt.route_departure_spans_.resize(tt.routes_.size());
+  set_route_days(tt, r_id);
+}
+
+}  // namespace motis::raptor
@@ -0,0 +1,394 @@
+#include "motis/raptor/update_raptor_timetable.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include "utl/erase_duplicates.h"
+#include "utl/to_vec.h"
+#include "utl/verify.h"
+
+#include "motis/core/access/trip_iterator.h"
+#include "motis/core/access/trip_section.h"
+#include "motis/core/access/trip_stop.h"
+
+namespace motis::raptor {
+
+namespace {
+
+// trip b neither departs nor arrives before trip a at any stop
+bool is_fifo(stop_time const* a, stop_time const* b, stop_count const sc) {
+  for (auto offset = 0U; offset < sc; ++offset) {
+    if (a[offset].arrival_ > b[offset].arrival_ ||
+        a[offset].departure_ > b[offset].departure_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+stop_time const* get_trip_stop_times(raptor_timetable const& tt,
+                                     raptor_route const& route,
+                                     trip_count const trip) {
+  return tt.stop_times_.data() + route.index_to_stop_times_ +
+         (trip * route.stop_count_);
+}
+
+std::vector<stop_id> get_route_stops(raptor_timetable const& tt,
+                                     route_id const r_id) {
+  auto const& route = tt.routes_[r_id];
+  auto const first = std::next(begin(tt.route_stops_),
+                               route.index_to_route_stops_);
+  return {first, std::next(first, route.stop_count_)};
+}
+
+void write_trip(raptor_meta_info& meta_info, raptor_timetable& tt,
+                raptor_route const& route, trip_count const trip,
+                raptor_trip_times const& t) {
+  auto const first = route.index_to_stop_times_ + (trip * route.stop_count_);
+  std::copy(begin(t.stop_times_), end(t.stop_times_),
+            std::next(begin(tt.stop_times_), first));
+  std::copy(begin(t.lcons_), end(t.lcons_),
+            std::next(begin(meta_info.lcon_ptr_), first));
+  for (auto offset = 0U; offset < route.stop_count_; ++offset) {
+    tt.route_departures_[route.index_to_stop_times_ +
+                         (offset * route.trip_count_) + trip] =
+        t.stop_times_[offset].departure_;
+  }
+}
+
+// Shrinking routes keep their stop times block. Growing routes move to a
+// new block at the end, the old block stays unused until the next rebuild.
+void resize_route(raptor_meta_info& meta_info, raptor_timetable& tt,
+                  route_id const r_id, trip_count const tc) {
+  auto& route = tt.routes_[r_id];
+  auto const used = static_cast<std::size_t>(route.trip_count_) *
+                    static_cast<std::size_t>(route.stop_count_);
+  if (tc > route.trip_count_) {
+    tt.unused_stop_times_ += used;
+    auto const first = tt.stop_times_.size();
+    auto const size = first + (tc * route.stop_count_);
+    tt.stop_times_.resize(size);
+    tt.route_departures_.resize(size, invalid<time>);
+    meta_info.lcon_ptr_.resize(size, nullptr);
+    route.index_to_stop_times_ = static_cast<stop_times_index>(first);
+    tt.routes_.back().index_to_stop_times_ =
+        static_cast<stop_times_index>(size);
+  } else {
+    tt.unused_stop_times_ += used - (tc * route.stop_count_);
+  }
+  route.trip_count_ = tc;
+}
+
+route_id add_route(raptor_timetable& tt, std::vector<stop_id> const& stops) {
+  auto const r_id = tt.route_count();
+  auto const sentinel = tt.routes_.back();
+  tt.routes_.back() =
+      raptor_route{0U, static_cast<stop_count>(stops.size()),
+                   sentinel.index_to_stop_times_,
+                   sentinel.index_to_route_stops_};
+  tt.route_stops_.insert(end(tt.route_stops_), begin(stops), end(stops));
+  tt.routes_.emplace_back(
+      0U, 0U, sentinel.index_to_stop_times_,
+      static_cast<route_stops_index>(tt.route_stops_.size()));
+  return r_id;
+}
+
+void add_stop_routes(raptor_timetable& tt, std::vector<route_id> const& added) {
+  if (added.empty()) {
+    return;
+  }
+
+  auto added_stop_routes =
+      std::vector<std::vector<route_id>>(tt.stop_count());
+  for (auto const r_id : added) {
+    for (auto const s_id : get_route_stops(tt, r_id)) {
+      added_stop_routes[s_id].push_back(r_id);
+    }
+  }
+
+  auto stop_routes = std::vector<route_id>{};
+  stop_routes.reserve(tt.stop_routes_.size() + added.size());
+  for (auto s_id = 0; s_id < tt.stop_count(); ++s_id) {
+    auto& stop = tt.stops_[s_id];
+    auto const first = std::next(begin(tt.stop_routes_),
+                                 stop.index_to_stop_routes_);
+    auto const idx = static_cast<stop_routes_index>(stop_routes.size());
+    stop_routes.insert(end(stop_routes), first,
+                       std::next(first, stop.route_count_));
+    utl::erase_duplicates(added_stop_routes[s_id]);
+    stop_routes.insert(end(stop_routes), begin(added_stop_routes[s_id]),
+                       end(added_stop_routes[s_id]));
+    stop.index_to_stop_routes_ = idx;
+    stop.route_count_ = static_cast<route_count>(stop_routes.size() - idx);
+  }
+  tt.stops_.back().index_to_stop_routes_ =
+      static_cast<stop_routes_index>(stop_routes.size());
+  tt.stop_routes_ = std::move(stop_routes);
+}
+
+// greedy first fit of the trips (ordered by departure) into FIFO chains
+std::vector<std::vector<raptor_trip_times>> get_fifo_chains(
+    std::vector<raptor_trip_times> trips, stop_count const sc) {
+  std::stable_sort(begin(trips), end(trips),
+                   [](raptor_trip_times const& a, raptor_trip_times const& b) {
+                     return std::tie(a.stop_times_.front().departure_,
+                                     a.stop_times_.back().arrival_) <
+                            std::tie(b.stop_times_.front().departure_,
+                                     b.stop_times_.back().arrival_);
+                   });
+
+  auto chains = std::vector<std::vector<raptor_trip_times>>{};
+  for (auto& t : trips) {
+    auto const chain = std::find_if(
+        begin(chains), end(chains),
+        [&](std::vector<raptor_trip_times> const& c) {
+          return c.size() < max_value<trip_count> &&
+                 is_fifo(c.back().stop_times_.data(), t.stop_times_.data(),
+                         sc);
+        });
+    if (chain == end(chains)) {
+      chains.emplace_back().emplace_back(std::move(t));
+    } else {
+      chain->emplace_back(std::move(t));
+    }
+  }
+  return chains;
+}
+
+raptor_trip_times get_trip_times(raptor_meta_info const& meta_info,
+                                 trip const* trp) {
+  raptor_trip_times t;
+  t.stop_times_.resize(trp->edges_->size() + 1U);
+  t.lcons_.reserve(trp->edges_->size() + 1U);
+  t.lcons_.push_back(nullptr);
+  for (auto const section : access::sections(trp)) {
+    auto const& lc = section.lcon();
+    if (section.from_node()->is_in_allowed()) {
+      t.stop_times_[section.index()].departure_ = lc.d_time_;
+    }
+    if (section.to_node()->is_out_allowed()) {
+      t.stop_times_[section.index() + 1].arrival_ = static_cast<time>(
+          lc.a_time_ + meta_info.transfer_times_[section.to_station_id()]);
+    }
+    t.lcons_.push_back(&lc);
+  }
+  return t;
+}
+
+void add_departure_event(std::vector<time>& events, time const dep) {
+  auto const it = std::lower_bound(begin(events), end(events), dep);
+  if (it == end(events) || *it != dep) {
+    events.insert(it, dep);
+  }
+}
+
+// the station itself and the stations with a footpath to it, see
+// transformable_to_meta_info
+void add_departure_events(raptor_meta_info& meta_info,
+                          raptor_timetable const& tt,
+                          std::vector<stop_id> const& stops,
+                          raptor_trip_times const& t) {
+  auto const add = [&](stop_id const s_id, time const dep) {
+    add_departure_event(meta_info.departure_events_[s_id], dep);
+    for (auto const equi : meta_info.equivalent_stations_[s_id]) {
+      add_departure_event(meta_info.departure_events_with_metas_[equi], dep);
+    }
+  };
+
+  for (auto offset = 0U; offset + 1U < stops.size(); ++offset) {
+    auto const dep = t.stop_times_[offset].departure_;
+    if (!valid(dep)) {
+      continue;
+    }
+    add(stops[offset], dep);
+    for (auto const& f : tt.incoming_footpaths_[stops[offset]]) {
+      auto const duration = f.duration_ + meta_info.transfer_times_[f.from_];
+      if (dep >= duration) {
+        add(f.from_, static_cast<time>(dep - duration));
+      }
+    }
+  }
+}
+
+std::optional<uint32_t> get_expanded_route(schedule const& sched,
+                                           trip const* trp) {
+  if (trp->edges_->empty()) {
+    return std::nullopt;
+  }
+  auto const route_id = trp->edges_->front()->from_->route_;
+  for (auto const exp_route_id :
+       sched.route_to_expanded_routes_.at(route_id)) {
+    auto const exp_route = sched.expanded_trips_.at(exp_route_id);
+    if (std::find(begin(exp_route), end(exp_route), trp) != end(exp_route)) {
+      return exp_route_id;
+    }
+  }
+  return std::nullopt;
+}
+
+// trips are identified by the light connection of their first section
+std::optional<std::pair<route_id, trip_count>> find_trip(
+    raptor_meta_info const& meta_info, raptor_timetable const& tt,
+    uint32_t const exp_route_id, trip const* trp) {
+  if (meta_info.expanded_route_routes_.size() <= exp_route_id) {
+    return std::nullopt;
+  }
+  auto const* lcon = &access::trip_section{trp, 0}.lcon();
+  for (auto const r_id : meta_info.expanded_route_routes_[exp_route_id]) {
+    auto const& route = tt.routes_[r_id];
+    for (trip_count trip = 0U; trip < route.trip_count_; ++trip) {
+      if (meta_info.lcon_ptr_[route.index_to_stop_times_ +
+                              (trip * route.stop_count_) + 1U] == lcon) {
+        return std::pair{r_id, trip};
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+bool rebuild_expanded_route(schedule const& sched, raptor_meta_info& meta_info,
+                            raptor_timetable& tt, uint32_t const exp_route_id,
+                            raptor_update_stats& stats) {
+  if (meta_info.expanded_route_routes_.size() <= exp_route_id) {
+    meta_info.expanded_route_routes_.resize(exp_route_id + 1U);
+  }
+
+  auto const& routes = meta_info.expanded_route_routes_[exp_route_id];
+  auto const exp_route = sched.expanded_trips_.at(exp_route_id);
+  if (exp_route.empty() && routes.empty()) {
+    return true;
+  }
+
+  auto const stops =
+      exp_route.empty()
+          ? get_route_stops(tt, routes.front())
+          : utl::to_vec(access::stops(exp_route.front()),
+                        [](access::trip_stop const& s) {
+                          return static_cast<stop_id>(s.get_station_id());
+                        });
+  if (!routes.empty() && get_route_stops(tt, routes.front()) != stops) {
+    return false;
+  }
+
+  auto trips = utl::to_vec(exp_route, [&](ptr<trip> const& trp) {
+    return get_trip_times(meta_info, trp);
+  });
+  for (auto const& t : trips) {
+    add_departure_events(meta_info, tt, stops, t);
+  }
+
+  meta_info.expanded_route_routes_[exp_route_id] =
+      set_route_trips(meta_info, tt, routes, stops, std::move(trips), stats);
+  ++stats.rebuilt_routes_;
+  return true;
+}
+
+}  // namespace
+
+bool update_trip_times(raptor_meta_info& meta_info, raptor_timetable& tt,
+                       route_id const r_id, trip_count const trip,
+                       raptor_trip_times const& t) {
+  auto const& route = tt.routes_[r_id];
+  utl::verify(t.stop_times_.size() == route.stop_count_,
+              "raptor: stop count of trip does not match route {}", r_id);
+
+  auto const* times = t.stop_times_.data();
+  if ((trip != 0U &&
+       !is_fifo(get_trip_stop_times(tt, route, trip - 1U), times,
+                route.stop_count_)) ||
+      (trip + 1U < route.trip_count_ &&
+       !is_fifo(times, get_trip_stop_times(tt, route, trip + 1U),
+                route.stop_count_))) {
+    return false;
+  }
+
+  write_trip(meta_info, tt, route, trip, t);
+  update_route_days(tt, r_id);
+  return true;
+}
+
+std::vector<route_id> set_route_trips(raptor_meta_info& meta_info,
+                                      raptor_timetable& tt,
+                                      std::vector<route_id> const& routes,
+                                      std::vector<stop_id> const& stops,
+                                      std::vector<raptor_trip_times> trips,
+                                      raptor_update_stats& stats) {
+  auto const sc = static_cast<stop_count>(stops.size());
+  auto const chains = get_fifo_chains(std::move(trips), sc);
+
+  auto result = routes;
+  auto added = std::vector<route_id>{};
+  while (result.size() < chains.size()) {
+    added.push_back(add_route(tt, stops));
+    result.push_back(added.back());
+  }
+  add_stop_routes(tt, added);
+  stats.added_routes_ += added.size();
+
+  for (auto i = 0U; i < result.size(); ++i) {
+    auto const r_id = result[i];
+    utl::verify(tt.routes_[r_id].stop_count_ == sc,
+                "raptor: stop count of route {} changed", r_id);
+
+    auto const tc = static_cast<trip_count>(
+        i < chains.size() ? chains[i].size() : 0U);
+    resize_route(meta_info, tt, r_id, tc);
+    for (trip_count trip = 0U; trip < tc; ++trip) {
+      write_trip(meta_info, tt, tt.routes_[r_id], trip, chains[i][trip]);
+    }
+    update_route_days(tt, r_id);
+  }
+
+  return result;
+}
+
+bool update_raptor_timetable(schedule const& sched, raptor_meta_info& meta_info,
+                             raptor_timetable& tt,
+                             std::vector<trip const*> const& delayed_trips,
+                             std::vector<uint32_t> const& expanded_routes,
+                             raptor_update_stats& stats) {
+  if (sched.stations_.size() != static_cast<std::size_t>(tt.stop_count())) {
+    return false;
+  }
+
+  auto rebuilt = std::set<uint32_t>{};
+  auto const rebuild = [&](uint32_t const exp_route_id) {
+    return !rebuilt.insert(exp_route_id).second ||
+           rebuild_expanded_route(sched, meta_info, tt, exp_route_id, stats);
+  };
+
+  for (auto const exp_route_id : expanded_routes) {
+    if (!rebuild(exp_route_id)) {
+      return false;
+    }
+  }
+
+  for (auto const* trp : delayed_trips) {
+    auto const exp_route_id = get_expanded_route(sched, trp);
+    if (!exp_route_id.has_value() ||
+        rebuilt.find(*exp_route_id) != end(rebuilt)) {
+      continue;  // removed or moved: handled by the expanded route update
+    }
+
+    auto const t = get_trip_times(meta_info, trp);
+    auto const pos = find_trip(meta_info, tt, *exp_route_id, trp);
+    if (pos.has_value() &&
+        update_trip_times(meta_info, tt, pos->first, pos->second, t)) {
+      add_departure_events(meta_info, tt, get_route_stops(tt, pos->first), t);
+      ++stats.updated_trips_;
+    } else if (!rebuild(*exp_route_id)) {
+      return false;
+    }
+  }
+
+  // blocks left behind by growing routes are only reclaimed by a rebuild
+  return tt.unused_stop_times_ <=
+         static_cast<std::size_t>(kMaxUnusedStopTimesShare *
+                                  static_cast<double>(tt.stop_times_.size()));
+}
+
+}  // namespace motis::raptor
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "motis/raptor/cpu/cpu_raptor.h"
+
+using namespace motis;
+using namespace motis::raptor;
+
+namespace {
+
+// one route with two stops, departures every ten minutes at the first stop
+void init_timetable(raptor_timetable& tt, trip_count const trips) {
+  tt.routes_.emplace_back(trips, 2, 0, 0);
+  tt.route_stops_ = {0, 1};
+  for (auto t = 0U; t < trips; ++t) {
+    tt.route_departures_.emplace_back(static_cast<motis::time>(100 + 10 * t));
+  }
+  tt.route_departures_.resize(2U * trips, invalid<motis::time>);
+  build_route_days(tt);
+}
+
+}  // namespace
+
+TEST(cpu_raptor_test, earliest_trip) {
+  for (auto const trips : {trip_count{3U}, trip_count{100U}}) {
+    raptor_timetable tt;
+    init_timetable(tt, trips);
+
+    auto arrivals = std::vector<motis::time>{invalid<motis::time>,
+                                           invalid<motis::time>};
+    EXPECT_EQ(invalid<trip_count>,
+              get_earliest_trip(tt, 0, arrivals.data(), 0));
+
+    arrivals[0] = 50;
+    EXPECT_EQ(0U, get_earliest_trip(tt, 0, arrivals.data(), 0));
+
+    arrivals[0] = 110;
+    EXPECT_EQ(1U, get_earliest_trip(tt, 0, arrivals.data(), 0));
+
+    arrivals[0] = 111;
+    EXPECT_EQ(2U, get_earliest_trip(tt, 0, arrivals.data(), 0));
+
+    arrivals[0] = static_cast<motis::time>(100 + 10 * trips);
+    EXPECT_EQ(invalid<trip_count>,
+              get_earliest_trip(tt, 0, arrivals.data(), 0));
+
+    // no departures at the last stop
+    arrivals[1] = 0;
+    EXPECT_EQ(invalid<trip_count>,
+              get_earliest_trip(tt, 0, arrivals.data(), 1));
+  }
+}
+
+TEST(cpu_raptor_test, earliest_trip_multi_day) {
+  // four stops, one trip every two hours over five days, 90 minutes from
+  // the first boarding stop to the next one, no departures at later stops
+  // (first_boarding = 1: boarding is not allowed at the first stop)
+  constexpr auto const trips = trip_count{60U};
+  constexpr auto const stops = 4U;
+  for (auto const first_boarding : {0U, 1U}) {
+    raptor_timetable tt;
+    tt.routes_.emplace_back(trips, stops, 0, 0);
+    tt.route_stops_ = {0, 1, 2, 3};
+    tt.route_departures_.resize(stops * trips, invalid<motis::time>);
+    for (auto t = 0U; t < trips; ++t) {
+      auto const departure = MINUTES_A_DAY + 120 * t;
+      tt.route_departures_[first_boarding * trips + t] =
+          static_cast<motis::time>(departure);
+      tt.route_departures_[(first_boarding + 1U) * trips + t] =
+          static_cast<motis::time>(departure + 90);
+    }
+    build_route_days(tt);
+    EXPECT_EQ(6U, tt.day_count_);
+    EXPECT_EQ(90U, tt.route_departure_spans_[0]);
+
+    for (auto arrival = 0U; arrival < 8U * MINUTES_A_DAY; arrival += 7U) {
+      auto const a = static_cast<motis::time>(arrival);
+      for (auto offset = 0U; offset < stops; ++offset) {
+        auto const column = std::next(begin(tt.route_departures_),
+                                      static_cast<long>(offset * trips));
+        auto const it =
+            std::lower_bound(column, std::next(column, trips), a);
+        auto const expected =
+            it == std::next(column, trips) || !valid(*it)
+                ? invalid<trip_count>
+                : static_cast<trip_count>(std::distance(column, it));
+        EXPECT_EQ(expected, get_earliest_departing_trip(tt, 0, offset, a));
+      }
+    }
+  }
+}
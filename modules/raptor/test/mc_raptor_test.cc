@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "motis/raptor/cpu/mc_raptor.h"
+
+using namespace motis;
+using namespace motis::raptor;
+
+namespace {
+
+struct test_route {
+  std::vector<stop_id> stops_;
+  // per trip and stop: arrival, departure
+  std::vector<std::vector<std::pair<motis::time, motis::time>>> trips_;
+  uint16_t price_per_ride_;
+};
+
+// price of every stop time, indexed like raptor_timetable::stop_times_
+std::vector<uint16_t> prices;  // NOLINT
+
+struct test_price_criterion {
+  using value_type = uint16_t;
+  static value_type ride(raptor_meta_info const&, stop_times_index const sti) {
+    return prices[sti];
+  }
+  static void write(journey&, value_type) {}
+};
+
+void init_timetable(raptor_timetable& tt, raptor_meta_info& meta_info,
+                    stop_id const stops,
+                    std::vector<test_route> const& routes) {
+  prices.clear();
+  std::vector<std::vector<route_id>> stop_routes(stops);
+  for (auto r_id = 0U; r_id < routes.size(); ++r_id) {
+    auto const& r = routes[r_id];
+    auto const sc = static_cast<stop_count>(r.stops_.size());
+    auto const tc = static_cast<trip_count>(r.trips_.size());
+    auto const sti = static_cast<stop_times_index>(tt.stop_times_.size());
+    tt.routes_.emplace_back(tc, sc, sti,
+                            static_cast<route_stops_index>(
+                                tt.route_stops_.size()));
+    for (auto const s : r.stops_) {
+      tt.route_stops_.push_back(s);
+      stop_routes[s].push_back(r_id);
+    }
+    for (auto const& trip : r.trips_) {
+      for (auto const& [arr, dep] : trip) {
+        tt.stop_times_.push_back(stop_time{arr, dep});
+        prices.push_back(r.price_per_ride_);
+      }
+    }
+    tt.route_departures_.resize(tt.stop_times_.size());
+    for (auto offset = 0U; offset < sc; ++offset) {
+      for (auto trip = 0U; trip < tc; ++trip) {
+        tt.route_departures_[sti + offset * tc + trip] =
+            tt.stop_times_[sti + trip * sc + offset].departure_;
+      }
+    }
+  }
+  tt.routes_.emplace_back(0, 0, tt.stop_times_.size(),
+                          tt.route_stops_.size());
+  build_route_days(tt);
+
+  for (stop_id s = 0; s < stops; ++s) {
+    tt.stops_.emplace_back(0, stop_routes[s].size(), 0,
+                           tt.stop_routes_.size());
+    tt.stop_routes_.insert(end(tt.stop_routes_), begin(stop_routes[s]),
+                           end(stop_routes[s]));
+    meta_info.equivalent_stations_.push_back({s});
+  }
+  tt.stops_.emplace_back(0, 0, 0, tt.stop_routes_.size());
+  meta_info.transfer_times_.resize(stops, 0);
+}
+
+constexpr auto const I = invalid<motis::time>;
+
+}  // namespace
+
+TEST(mc_raptor_test, pareto_set) {
+  raptor_timetable tt;
+  raptor_meta_info meta_info;
+  init_timetable(
+      tt, meta_info, 3,
+      {// 0 -> 2: slow and cheap
+       {{0, 2}, {{{I, 10}, {100, I}}}, 1},
+       // 0 -> 1 -> 2: fast and expensive
+       {{0, 1, 2}, {{{I, 10}, {20, 20}, {40, I}}}, 5},
+       // 0 -> 1, 1 -> 2: cheap with a transfer
+       {{0, 1}, {{{I, 10}, {15, I}}}, 1},
+       {{1, 2}, {{{I, 30}, {50, I}}, {{I, 60}, {70, I}}}, 1}});
+
+  base_query q;
+  q.source_ = 0;
+  q.target_ = 2;
+  q.source_time_begin_ = 5;
+  q.source_time_end_ = 5;
+  q.use_start_metas_ = false;
+  q.use_dest_metas_ = false;
+  q.use_start_footpaths_ = false;
+
+  raptor_statistics stats;
+
+  mc_raptor_search<test_price_criterion> mc{meta_info, tt};
+  mc.search(q, q.source_time_begin_, stats);
+
+  auto results = std::vector<std::tuple<motis::time, raptor_round, uint16_t>>{};
+  for (auto const idx : mc.get_target_labels()) {
+    results.emplace_back(mc[idx].arrival_, mc[idx].round_, mc[idx].value_);
+  }
+  std::sort(begin(results), end(results));
+  EXPECT_EQ((std::vector<std::tuple<motis::time, raptor_round, uint16_t>>{
+                {40, 1, 10}, {40, 2, 6}, {50, 2, 2}, {100, 1, 1}}),
+            results);
+
+  mc_raptor_search<no_criterion> fastest{meta_info, tt};
+  fastest.search(q, q.source_time_begin_, stats);
+  auto const labels = fastest.get_target_labels();
+  ASSERT_EQ(1U, labels.size());
+  EXPECT_EQ(40, fastest[labels.front()].arrival_);
+  EXPECT_EQ(1, fastest[labels.front()].round_);
+}
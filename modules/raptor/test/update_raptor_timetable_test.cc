@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "motis/raptor/cpu/cpu_raptor.h"
+#include "motis/raptor/update_raptor_timetable.h"
+
+using namespace motis;
+using namespace motis::raptor;
+
+namespace {
+
+// departure at the first stop, arrival at the second stop
+raptor_trip_times make_trip(motis::time const dep, motis::time const arr) {
+  raptor_trip_times t;
+  t.stop_times_ = {stop_time{invalid<motis::time>, dep},
+                   stop_time{arr, invalid<motis::time>}};
+  t.lcons_ = {nullptr, nullptr};
+  return t;
+}
+
+// three stops, no routes
+void init_timetable(raptor_timetable& tt, raptor_meta_info& meta_info) {
+  for (auto s_id = 0; s_id < 4; ++s_id) {
+    tt.stops_.emplace_back(0, 0, 0, 0);
+  }
+  tt.routes_.emplace_back(0, 0, 0, 0);
+  tt.incoming_footpaths_.resize(3);
+  meta_info.transfer_times_.resize(3, 0);
+}
+
+std::vector<route_id> get_stop_routes(raptor_timetable const& tt,
+                                      stop_id const s_id) {
+  auto const& stop = tt.stops_[s_id];
+  auto const first =
+      std::next(begin(tt.stop_routes_), stop.index_to_stop_routes_);
+  return {first, std::next(first, stop.route_count_)};
+}
+
+motis::time get_arrival(raptor_timetable const& tt, route_id const r_id,
+                        trip_count const trip) {
+  auto const& route = tt.routes_[r_id];
+  return tt.stop_times_[route.index_to_stop_times_ +
+                        (trip * route.stop_count_) + 1U]
+      .arrival_;
+}
+
+}  // namespace
+
+TEST(update_raptor_timetable_test, set_route_trips) {
+  raptor_timetable tt;
+  raptor_meta_info meta_info;
+  init_timetable(tt, meta_info);
+  raptor_update_stats stats;
+
+  auto const r0 = set_route_trips(meta_info, tt, {}, {0, 1},
+                                  {make_trip(20, 30), make_trip(10, 20)},
+                                  stats);
+  ASSERT_EQ(std::vector<route_id>{0U}, r0);
+  EXPECT_EQ(1U, tt.route_count());
+  EXPECT_EQ(2U, tt.routes_[0].trip_count_);
+  EXPECT_EQ(std::vector<route_id>{0U}, get_stop_routes(tt, 0));
+  EXPECT_EQ(std::vector<route_id>{0U}, get_stop_routes(tt, 1));
+  EXPECT_TRUE(get_stop_routes(tt, 2).empty());
+  EXPECT_EQ(20U, get_arrival(tt, 0, 0));
+  EXPECT_EQ(1U, get_earliest_departing_trip(tt, 0, 0, 11));
+
+  // overtaking trip: split into a second route
+  auto const r1 = set_route_trips(
+      meta_info, tt, r0, {0, 1},
+      {make_trip(10, 20), make_trip(20, 30), make_trip(15, 40)}, stats);
+  ASSERT_EQ((std::vector<route_id>{0U, 1U}), r1);
+  EXPECT_EQ(2U, stats.added_routes_);
+  EXPECT_EQ(2U, tt.routes_[0].trip_count_);
+  EXPECT_EQ(40U, get_arrival(tt, 0, 1));
+  EXPECT_EQ(1U, tt.routes_[1].trip_count_);
+  EXPECT_EQ(30U, get_arrival(tt, 1, 0));
+  EXPECT_EQ((std::vector<route_id>{0U, 1U}), get_stop_routes(tt, 0));
+  EXPECT_EQ((std::vector<route_id>{0U, 1U}), get_stop_routes(tt, 1));
+  EXPECT_EQ(tt.stop_times_.size(), tt.routes_.back().index_to_stop_times_);
+
+  // a route for other stops
+  set_route_trips(meta_info, tt, {}, {1, 2}, {make_trip(50, 60)}, stats);
+  EXPECT_EQ(3U, tt.route_count());
+  EXPECT_EQ((std::vector<route_id>{0U, 1U, 2U}), get_stop_routes(tt, 1));
+  EXPECT_EQ(std::vector<route_id>{2U}, get_stop_routes(tt, 2));
+
+  // removed trips: the second route stays without trips
+  set_route_trips(meta_info, tt, r1, {0, 1}, {make_trip(10, 20)}, stats);
+  EXPECT_EQ(1U, tt.routes_[0].trip_count_);
+  EXPECT_EQ(0U, tt.routes_[1].trip_count_);
+  EXPECT_EQ(invalid<trip_count>,
+            get_earliest_departing_trip(tt, 1, 0, 0));
+
+  // the old block of a growing route is no longer used
+  set_route_trips(meta_info, tt, r1, {0, 1},
+                  {make_trip(10, 20), make_trip(20, 30), make_trip(30, 40)},
+                  stats);
+  EXPECT_EQ(3U, tt.routes_[0].trip_count_);
+  auto used = std::size_t{0U};
+  for (auto r_id = route_id{0U}; r_id < tt.route_count(); ++r_id) {
+    used += tt.routes_[r_id].trip_count_ * tt.routes_[r_id].stop_count_;
+  }
+  EXPECT_EQ(6U, tt.unused_stop_times_);
+  EXPECT_EQ(tt.stop_times_.size() - used, tt.unused_stop_times_);
+}
+
+TEST(update_raptor_timetable_test, update_trip_times) {
+  raptor_timetable tt;
+  raptor_meta_info meta_info;
+  init_timetable(tt, meta_info);
+  raptor_update_stats stats;
+
+  set_route_trips(meta_info, tt, {}, {0, 1},
+                  {make_trip(10, 20), make_trip(20, 30), make_trip(30, 40)},
+                  stats);
+
+  EXPECT_TRUE(update_trip_times(meta_info, tt, 0, 1, make_trip(25, 35)));
+  EXPECT_EQ(35U, get_arrival(tt, 0, 1));
+  EXPECT_EQ(1U, get_earliest_departing_trip(tt, 0, 0, 21));
+  EXPECT_EQ(2U, get_earliest_departing_trip(tt, 0, 0, 26));
+
+  // overtakes the next trip
+  EXPECT_FALSE(update_trip_times(meta_info, tt, 0, 1, make_trip(25, 45)));
+  EXPECT_EQ(35U, get_arrival(tt, 0, 1));
+}
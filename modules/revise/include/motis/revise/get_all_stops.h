@@ -2,15 +2,20 @@
 
 #include <vector>
 
+#include "motis/core/schedule/event.h"
 #include "motis/core/schedule/schedule.h"
 #include "motis/core/journey/journey.h"
 
 #include "motis/revise/section.h"
+#include "motis/revise/section_cache.h"
 #include "motis/revise/stop.h"
 
 namespace motis::revise {
 
 std::vector<section> get_sections(journey const& j);
-std::vector<stop_ptr> get_all_stops(schedule const& sched, journey const& j);
+std::vector<ev_key> get_shortest_path(schedule const& sched, journey const& j,
+                                      int from, int to);
+std::vector<stop_ptr> get_all_stops(schedule const& sched, journey const& j,
+                                    section_cache const* cache = nullptr);
 
 }  // namespace motis::revise
@@ -12,6 +12,9 @@
 
 namespace motis::revise {
 
+extern_trip const& get_extern_trip(journey const& j, unsigned stop_idx,
+                                   event_type ev_type);
+
 ev_key get_ev_key(schedule const& sched, journey const& j, unsigned stop_idx,
                   event_type ev_type);
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "motis/core/common/unixtime.h"
+#include "motis/core/schedule/event.h"
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/journey/extern_trip.h"
+#include "motis/core/journey/journey.h"
+
+namespace motis::revise {
+
+// Route edges of the trip sections of a batch of journeys. Saved journeys
+// often use the same trains: every distinct section (trip, boarding stop,
+// alighting station) is resolved only once, in parallel. The cache is
+// read-only afterwards and can be shared by concurrent journey updates.
+struct section_cache {
+  using key = std::tuple<extern_trip, std::string /* from eva */,
+                         unixtime /* from schedule departure */,
+                         std::string /* to eva */>;
+
+  section_cache() = default;
+  section_cache(schedule const&, std::vector<journey> const&);
+
+  // nullptr if the section was not resolved (falls back to a fresh lookup)
+  std::vector<ev_key> const* find(journey const&, int from, int to) const;
+
+private:
+  std::map<key, std::vector<ev_key>> paths_;
+};
+
+}  // namespace motis::revise
@@ -6,10 +6,12 @@
 #include "motis/core/journey/journey.h"
 
 #include "motis/revise/extern_interchange.h"
+#include "motis/revise/section_cache.h"
 
 namespace motis::revise {
 
-journey update_journey(schedule const&, journey const&);
+journey update_journey(schedule const&, journey const&,
+                       section_cache const* = nullptr);
 
 std::vector<extern_interchange> get_interchanges(journey const&);
 
@@ -384,9 +384,14 @@ std::vector<section> get_sections(journey const& j) {
 }
 
 std::vector<stop_ptr> get_trip_stops(schedule const& sched, journey const& j,
-                                     int from, int to) {
+                                     int from, int to,
+                                     section_cache const* cache) {
+  auto const cached = cache == nullptr ? nullptr : cache->find(j, from, to);
+  auto const path =
+      cached == nullptr ? get_shortest_path(sched, j, from, to) : *cached;
+
   std::vector<stop_ptr> stops;
-  for (auto const& k : get_shortest_path(sched, j, from, to)) {
+  for (auto const& k : path) {
     if (stops.empty()) {
       stops.emplace_back(std::make_unique<trip_stop>(sched, ev_key{}, k, true,
                                                      true, journey::stop{}));
@@ -567,14 +572,16 @@ void generate_stops(schedule const& sched, std::vector<stop_ptr>& stops) {
   stops.back()->dep_sched_time_ = INVALID_TIME;
 }
 
-std::vector<stop_ptr> get_all_stops(schedule const& sched, journey const& j) {
+std::vector<stop_ptr> get_all_stops(schedule const& sched, journey const& j,
+                                    section_cache const* cache) {
   std::vector<stop_ptr> stops;
   for (auto const& section : get_sections(j)) {
     if (section.from_ == section.to_) {
       continue;
     }
     if (section.type_ == section_type::TRIP) {
-      auto trip_stops = get_trip_stops(sched, j, section.from_, section.to_);
+      auto trip_stops =
+          get_trip_stops(sched, j, section.from_, section.to_, cache);
       stops.insert(end(stops), std::make_move_iterator(begin(trip_stops)),
                    std::make_move_iterator(trip_stops.end()));
 
@@ -10,8 +10,8 @@
 
 namespace motis::revise {
 
-ev_key get_ev_key(schedule const& sched, journey const& j,
-                  unsigned const stop_idx, event_type const ev_type) {
+extern_trip const& get_extern_trip(journey const& j, unsigned const stop_idx,
+                                   event_type const ev_type) {
   auto const is_arr = (ev_type == event_type::ARR);
   auto const journey_trp =
       std::find_if(begin(j.trips_), end(j.trips_), [&](journey::trip const& t) {
@@ -20,8 +20,13 @@ ev_key get_ev_key(schedule const& sched, journey const& j,
       });
   utl::verify(journey_trp != end(j.trips_),
               "get ev key(trip): invalid journey");
+  return journey_trp->extern_trip_;
+}
 
-  auto const trp = get_trip(sched, journey_trp->extern_trip_);
+ev_key get_ev_key(schedule const& sched, journey const& j,
+                  unsigned const stop_idx, event_type const ev_type) {
+  auto const is_arr = (ev_type == event_type::ARR);
+  auto const trp = get_trip(sched, get_extern_trip(j, stop_idx, ev_type));
   auto const& stop = j.stops_[stop_idx];
   auto const schedule_time = is_arr ? stop.arrival_.schedule_timestamp_
                                     : stop.departure_.schedule_timestamp_;
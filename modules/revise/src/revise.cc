@@ -1,10 +1,16 @@
 #include "motis/revise/revise.h"
 
+#include <numeric>
+#include <vector>
+
 #include "boost/program_options.hpp"
 
 #include "motis/core/journey/journeys_to_message.h"
 #include "motis/core/journey/message_to_journeys.h"
+#include "motis/module/context/motis_parallel_for.h"
 #include "motis/module/event_collector.h"
+
+#include "motis/revise/section_cache.h"
 #include "motis/revise/update_journey.h"
 
 using namespace motis::module;
@@ -52,15 +58,28 @@ msg_ptr revise::update(Connection const* con) {
 }
 
 msg_ptr revise::update(ReviseRequest const* req) {
+  auto const& sched = get_sched();
+  auto const journeys = utl::to_vec(*req->connections(),
+                                    [](Connection const* con) {
+                                      return convert(con);
+                                    });
+
+  // journeys of one request share the lookups of common trip sections
+  auto const cache = section_cache{sched, journeys};
+  auto updated = std::vector<journey>(journeys.size());
+  auto indices = std::vector<std::size_t>(journeys.size());
+  std::iota(begin(indices), end(indices), std::size_t{0U});
+  motis_parallel_for(indices, [&](std::size_t const i) {
+    updated[i] = update_journey(sched, journeys[i], &cache);
+  });
+
   message_creator fbb;
   fbb.create_and_finish(
       MsgContent_ReviseResponse,
       CreateReviseResponse(fbb, fbb.CreateVector(utl::to_vec(
-                                    *req->connections(),
-                                    [&](Connection const* con) {
-                                      return to_connection(
-                                          fbb, update_journey(get_sched(),
-                                                              convert(con)));
+                                    updated,
+                                    [&](journey const& j) {
+                                      return to_connection(fbb, j);
                                     })))
           .Union());
   return make_msg(fbb);
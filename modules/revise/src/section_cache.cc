@@ -0,0 +1,83 @@
+#include "motis/revise/section_cache.h"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "motis/module/context/motis_parallel_for.h"
+
+#include "motis/revise/get_all_stops.h"
+#include "motis/revise/get_ev_key.h"
+
+namespace motis::revise {
+
+namespace {
+
+section_cache::key get_key(journey const& j, int const from, int const to) {
+  auto const& from_stop = j.stops_.at(from);
+  return {get_extern_trip(j, from, event_type::DEP), from_stop.eva_no_,
+          from_stop.departure_.schedule_timestamp_, j.stops_.at(to).eva_no_};
+}
+
+}  // namespace
+
+section_cache::section_cache(schedule const& sched,
+                             std::vector<journey> const& journeys) {
+  struct task {
+    std::size_t idx_;
+    journey const* j_;
+    int from_, to_;
+  };
+
+  auto keys = std::vector<key>{};
+  auto tasks = std::vector<task>{};
+  auto known = std::map<key, std::size_t>{};
+  for (auto const& j : journeys) {
+    if (std::none_of(begin(j.stops_), end(j.stops_),
+                     [](journey::stop const& s) { return s.enter_; })) {
+      continue;
+    }
+    try {
+      for (auto const& s : get_sections(j)) {
+        if (s.type_ != section_type::TRIP || s.from_ == s.to_) {
+          continue;
+        }
+        auto k = get_key(j, s.from_, s.to_);
+        if (known.emplace(k, keys.size()).second) {
+          tasks.emplace_back(task{keys.size(), &j, s.from_, s.to_});
+          keys.emplace_back(std::move(k));
+        }
+      }
+    } catch (std::exception const&) {
+      // invalid journey: reported by its own update
+    }
+  }
+
+  auto paths = std::vector<std::optional<std::vector<ev_key>>>(tasks.size());
+  motis_parallel_for(tasks, [&](task const& t) {
+    try {
+      paths[t.idx_] = get_shortest_path(sched, *t.j_, t.from_, t.to_);
+    } catch (std::exception const&) {
+      // not cached: the journey update repeats the lookup and reports it
+    }
+  });
+
+  for (auto i = 0U; i != keys.size(); ++i) {
+    if (paths[i].has_value()) {
+      paths_.emplace(std::move(keys[i]), std::move(*paths[i]));
+    }
+  }
+}
+
+std::vector<ev_key> const* section_cache::find(journey const& j,
+                                               int const from,
+                                               int const to) const {
+  if (paths_.empty()) {
+    return nullptr;
+  }
+  auto const it = paths_.find(get_key(j, from, to));
+  return it == end(paths_) ? nullptr : &it->second;
+}
+
+}  // namespace motis::revise
@@ -81,8 +81,9 @@ void edges_to_journey(
     interval_map<free_text const*, free_text_cmp>& free_texts,
     interval_map<trip const*, trp_cmp>& trip_intervals,
     interval_map<connection_info const*, con_info_cmp>& transport_intervals,
-    interval_map<attribute const*>& attribute_intervals) {
-  auto const stops = get_all_stops(sched, j);
+    interval_map<attribute const*>& attribute_intervals,
+    section_cache const* cache) {
+  auto const stops = get_all_stops(sched, j, cache);
   for (auto const& stop : stops) {
     auto& new_stop = new_journey.stops_.emplace_back(stop->get_stop(sched));
     auto const stop_size = new_journey.stops_.size() - 1;
@@ -165,7 +166,8 @@ int get_stop_idx(journey const& con, int const schedule_time,
   return std::distance(begin(con.stops_), event_info);
 }
 
-journey update_journey(schedule const& sched, journey const& j) {
+journey update_journey(schedule const& sched, journey const& j,
+                       section_cache const* cache) {
   if (j.stops_.empty() ||
       std::none_of(begin(j.stops_), end(j.stops_),
                    [](journey::stop const& s) { return s.enter_; })) {
@@ -180,7 +182,8 @@ journey update_journey(schedule const& sched, journey const& j) {
 
   // compute stations and intervals
   edges_to_journey(sched, j, updated_journey, free_text_intervals,
-                   trip_intervals, transport_intervals, attribute_intervals);
+                   trip_intervals, transport_intervals, attribute_intervals,
+                   cache);
 
   // compute free_texts
   for (auto const& [free_text, range] :
@@ -97,6 +97,42 @@ TEST_F(revise_itest, update_timestamps) {
   ASSERT_EQ(updated_j.stops_.at(13).arrival_.timestamp_, unix_time(1612));
 }
 
+TEST_F(revise_itest, update_batch) {
+  auto const con = call(get_routing_request(unix_time(1500), unix_time(1612),
+                                            "8002059", "8000156"));
+  auto const resp_routing = motis_content(RoutingResponse, con);
+  auto journeys = message_to_journeys(resp_routing);
+
+  ASSERT_EQ(journeys.size(), 1);
+  auto j = journeys.front();
+
+  j.stops_.at(0).departure_.timestamp_ = unix_time(2200);
+  j.stops_.at(13).arrival_.timestamp_ = unix_time(2200);
+
+  // same trip sections in every journey: resolved once, shared by all
+  message_creator fbb;
+  fbb.create_and_finish(
+      MsgContent_ReviseRequest,
+      CreateReviseRequest(
+          fbb, fbb.CreateVector(std::vector<flatbuffers::Offset<Connection>>{
+                   to_connection(fbb, j), to_connection(fbb, j),
+                   to_connection(fbb, journeys.front())}))
+          .Union(),
+      "/revise", DestinationType_Topic);
+  auto const resp_update = call(make_msg(fbb));
+  auto const updated_connections =
+      motis_content(ReviseResponse, resp_update)->connections();
+
+  ASSERT_EQ(updated_connections->size(), 3);
+  for (auto const& updated_connection : *updated_connections) {
+    auto const updated_j = convert(updated_connection);
+    ASSERT_EQ(updated_j.stops_.size(), journeys.front().stops_.size());
+    ASSERT_EQ(updated_j.stops_.at(0).departure_.timestamp_, unix_time(1500));
+    ASSERT_EQ(updated_j.stops_.at(10).departure_.timestamp_, unix_time(1537));
+    ASSERT_EQ(updated_j.stops_.at(13).arrival_.timestamp_, unix_time(1612));
+  }
+}
+
 TEST_F(revise_itest, update_free_texts) {
   auto const con = call(get_routing_request(unix_time(1500), unix_time(1612),
                                             "8002059", "8000156"));
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "motis/routing/allocator.h"
+#include "motis/routing/node_label_store.h"
 
 namespace motis::routing {
 
@@ -24,9 +25,7 @@ public:
   void reset() {
     allocations_ = 0;
     alloc_.clear();
-    for (auto& labels : node_labels_) {
-      labels.clear();
-    }
+    node_labels_.clear();
   }
 
   template <typename T, typename... Args>
@@ -41,20 +40,23 @@ public:
     alloc_.dealloc(ptr);
   }
 
-  template <typename T>
-  std::vector<std::vector<T*>>* get_node_labels(std::size_t size) {
-    node_labels_.resize(size);
-    return reinterpret_cast<std::vector<std::vector<T*>>*>(&node_labels_);
+  node_label_store& get_node_labels(std::size_t const node_count) {
+    node_labels_.resize(node_count);
+    return node_labels_;
   }
 
   size_t allocations() const { return allocations_; }
 
-  size_t get_num_bytes_in_use() const { return alloc_.get_num_bytes_in_use(); }
+  size_t get_num_bytes_in_use() const {
+    return alloc_.get_num_bytes_in_use() + node_labels_.get_num_bytes_in_use();
+  }
+
+  size_t nodes_touched() const { return node_labels_.nodes_touched(); }
 
 private:
   size_t allocations_;
   allocator alloc_;
-  std::vector<std::vector<void*>> node_labels_;
+  node_label_store node_labels_;
 };
 
 }  // namespace motis::routing
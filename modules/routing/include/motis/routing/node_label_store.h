@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace motis::routing {
+
+// Labels of one node. The storage is owned by the node_label_store.
+// The most recently added label is stored last.
+struct label_bag {
+  template <typename T>
+  T* get(std::uint32_t const i) const {
+    assert(i < size_);
+    return static_cast<T*>(data_[i]);
+  }
+
+  // keeps the order of the remaining labels
+  void erase(std::uint32_t const i) {
+    assert(i < size_);
+    std::memmove(data_ + i, data_ + i + 1, (size_ - i - 1) * sizeof(void*));
+    --size_;
+  }
+
+  std::uint32_t size() const { return size_; }
+  bool empty() const { return size_ == 0U; }
+
+  void** data_{nullptr};
+  std::uint32_t size_{0U};
+  std::uint8_t size_class_{0U};  // capacity = kMinCapacity << size_class_
+};
+
+// Per node label lists of the pareto dijkstra.
+//
+// All lists share a pooled arena (one free list per size class) instead of
+// one heap allocation per node. Nodes are remembered when they get their first
+// label, so clear() only touches the nodes visited by the last search.
+struct node_label_store {
+  static constexpr auto const kMinCapacity = std::uint32_t{4U};
+  static constexpr auto const kBlockSize = std::size_t{1U} << 16U;
+
+  node_label_store() = default;
+
+  node_label_store(node_label_store const&) = delete;
+  node_label_store& operator=(node_label_store const&) = delete;
+
+  node_label_store(node_label_store&&) = delete;
+  node_label_store& operator=(node_label_store&&) = delete;
+
+  ~node_label_store() = default;
+
+  void resize(std::size_t const node_count) {
+    if (bags_.size() < node_count) {
+      bags_.resize(node_count);
+    }
+  }
+
+  label_bag& operator[](std::size_t const node_id) {
+    assert(node_id < bags_.size());
+    return bags_[node_id];
+  }
+
+  void push_back(std::size_t const node_id, void* label) {
+    auto& bag = (*this)[node_id];
+    if (bag.data_ == nullptr) {
+      touched_.emplace_back(static_cast<std::uint32_t>(node_id));
+      bag.size_class_ = 0U;
+      bag.data_ = alloc(0U);
+    } else if (bag.size_ == capacity(bag.size_class_)) {
+      auto const old_data = bag.data_;
+      auto const old_size_class = bag.size_class_;
+      ++bag.size_class_;
+      bag.data_ = alloc(bag.size_class_);
+      std::memcpy(bag.data_, old_data, bag.size_ * sizeof(void*));
+      dealloc(old_data, old_size_class);
+    }
+    bag.data_[bag.size_++] = label;
+  }
+
+  void clear() {
+    for (auto const node_id : touched_) {
+      bags_[node_id] = label_bag{};
+    }
+    touched_.clear();
+    free_lists_.fill(nullptr);
+    block_idx_ = 0U;
+    block_pos_ = 0U;
+  }
+
+  std::size_t nodes_touched() const { return touched_.size(); }
+
+  std::size_t get_num_bytes_in_use() const {
+    auto bytes = bags_.size() * sizeof(label_bag) +
+                 touched_.capacity() * sizeof(std::uint32_t);
+    for (auto const& b : blocks_) {
+      bytes += b.size_ * sizeof(void*);
+    }
+    return bytes;
+  }
+
+private:
+  struct block {
+    std::unique_ptr<void*[]> mem_;
+    std::size_t size_;
+  };
+
+  static std::uint32_t capacity(std::uint8_t const size_class) {
+    return kMinCapacity << size_class;
+  }
+
+  void** alloc(std::uint8_t const size_class) {
+    if (auto const head = free_lists_[size_class]; head != nullptr) {
+      free_lists_[size_class] = static_cast<void**>(*head);
+      return head;
+    }
+
+    auto const n = static_cast<std::size_t>(capacity(size_class));
+    while (block_idx_ != blocks_.size() &&
+           block_pos_ + n > blocks_[block_idx_].size_) {
+      ++block_idx_;
+      block_pos_ = 0U;
+    }
+    if (block_idx_ == blocks_.size()) {
+      auto const size = std::max(kBlockSize, n);
+      blocks_.emplace_back(block{std::make_unique<void*[]>(size), size});
+    }
+
+    auto const mem = blocks_[block_idx_].mem_.get() + block_pos_;
+    block_pos_ += n;
+    return mem;
+  }
+
+  void dealloc(void** mem, std::uint8_t const size_class) {
+    *mem = free_lists_[size_class];
+    free_lists_[size_class] = mem;
+  }
+
+  std::vector<label_bag> bags_;
+  std::vector<std::uint32_t> touched_;
+  std::vector<block> blocks_;
+  std::size_t block_idx_{0U}, block_pos_{0U};
+  std::array<void**, 32> free_lists_{};
+};
+
+}  // namespace motis::routing
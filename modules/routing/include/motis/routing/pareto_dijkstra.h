@@ -41,7 +41,7 @@ struct pareto_dijkstra {
       : sched_(sched),
         is_goal_(is_goal),
         station_node_count_(station_node_count),
-        node_labels_(*label_store.get_node_labels<Label>(node_count)),
+        node_labels_(label_store.get_node_labels(node_count)),
         additional_edges_(std::move(additional_edges)),
         lower_bounds_(lower_bounds),
         label_store_(label_store),
@@ -88,7 +88,7 @@ struct pareto_dijkstra {
       trace("\n");
 
       if (!l->is_filtered(fastest_direct_)) {
-        node_labels_[l->get_node()->id_].emplace_back(l);
+        node_labels_.push_back(l->get_node()->id_, l);
         queue_.push(l);
       }
     }
@@ -253,9 +253,11 @@ private:
   }
 
   bool add_label_to_node(Label* new_label, node const* dest) {
+    // newest labels first: earlier labels tend not to dominate later ones
+    // (not comparable), so this is very important for the performance
     auto& dest_labels = node_labels_[dest->id_];
-    for (auto it = dest_labels.begin(); it != dest_labels.end();) {
-      Label* o = *it;
+    for (auto i = dest_labels.size(); i != 0U; --i) {
+      Label* o = dest_labels.get<Label>(i - 1U);
       if (o->dominates(*new_label)) {
         print_dominated("BY_OLD_NODE_LABEL", o, new_label);
         return false;
@@ -263,16 +265,12 @@ private:
 
       if (new_label->dominates(*o)) {
         print_dominated("BY_OLD_NODE_LABEL", new_label, o);
-        it = dest_labels.erase(it);
+        dest_labels.erase(i - 1U);
         o->dominated_ = true;
-      } else {
-        ++it;
       }
     }
 
-    // it is very important for the performance to push front here
-    // because earlier labels tend not to dominate later ones (not comparable)
-    dest_labels.insert(std::begin(dest_labels), new_label);
+    node_labels_.push_back(dest->id_, new_label);
     return true;
   }
 
@@ -303,7 +301,7 @@ private:
   schedule const& sched_;
   std::vector<bool> const& is_goal_;
   unsigned int station_node_count_;
-  std::vector<std::vector<Label*>>& node_labels_;
+  node_label_store& node_labels_;
   dial<Label*, Label::MAX_BUCKET, get_bucket> queue_;
   std::vector<Label*> equals_;
   mcd::hash_map<node const*, std::vector<edge>> additional_edges_;
@@ -32,6 +32,7 @@ private:
 
   std::mutex mem_pool_mutex_;
   std::vector<std::unique_ptr<memory>> mem_pool_;
+  unsigned cache_ttl_{0U};
   bool import_successful_{false};
 };
 
@@ -33,6 +33,7 @@ struct statistics {
   uint64_t total_calculation_time_{};
   uint64_t pareto_dijkstra_{};
   uint64_t num_bytes_in_use_{};
+  uint64_t nodes_touched_{};
   uint64_t labels_to_journey_{};
   uint64_t interval_extensions_{};
 
@@ -63,6 +64,7 @@ struct statistics {
               s.labels_popped_until_first_result_);
     add_entry("labels_to_journey", s.labels_to_journey_);
     add_entry("max_label_quit", s.max_label_quit_ ? 1 : 0);
+    add_entry("nodes_touched", s.nodes_touched_);
     add_entry("num_bytes_in_use", s.num_bytes_in_use_);
     add_entry("pareto_dijkstra", s.pareto_dijkstra_);
     add_entry("priority_queue_max_size", s.priority_queue_max_size_);
@@ -95,6 +97,7 @@ struct statistics {
           s.labels_popped_until_first_result_},
          {"labels_to_journey", s.labels_to_journey_},
          {"max_label_quit", s.max_label_quit_ ? 1U : 0U},
+         {"nodes_touched", s.nodes_touched_},
          {"num_bytes_in_use", s.num_bytes_in_use_},
          {"pareto_dijkstra", s.pareto_dijkstra_},
          {"priority_queue_max_size", s.priority_queue_max_size_},
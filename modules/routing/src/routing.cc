@@ -34,7 +34,10 @@ using namespace motis::module;
 
 namespace motis::routing {
 
-routing::routing() : module("Routing", "routing") {}
+routing::routing() : module("Routing", "routing") {
+  param(cache_ttl_, "cache_ttl",
+        "cache /routing responses for this many seconds (0 = disabled)");
+}
 
 routing::~routing() = default;
 
@@ -47,7 +50,8 @@ void routing::reg_subc(motis::module::subc_reg& r) {
 
 void routing::init(motis::module::registry& reg) {
   reg.register_op("/routing", [this](msg_ptr const& msg) { return route(msg); },
-                  {kScheduleReadAccess});
+                  {kScheduleReadAccess},
+                  with_cache_ttl({}, std::chrono::seconds{cache_ttl_}));
   reg.register_op(
       "/trip_to_connection",
       [this](msg_ptr const& msg) { return trip_to_connection(msg); },
@@ -89,6 +93,7 @@ msg_ptr routing::route(msg_ptr const& msg) {
   res.stats_.total_calculation_time_ = MOTIS_TIMING_MS(routing_timing);
   res.stats_.labels_created_ = query.mem_->allocations();
   res.stats_.num_bytes_in_use_ = query.mem_->get_num_bytes_in_use();
+  res.stats_.nodes_touched_ = query.mem_->nodes_touched();
 
   message_creator fbb;
   std::vector<flatbuffers::Offset<Statistics>> stats{
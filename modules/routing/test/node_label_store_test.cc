@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "motis/routing/node_label_store.h"
+
+using namespace motis::routing;
+
+namespace {
+
+std::vector<int*> labels_of(node_label_store& store, std::size_t node_id) {
+  std::vector<int*> labels;
+  auto const& bag = store[node_id];
+  for (auto i = 0U; i != bag.size(); ++i) {
+    labels.emplace_back(bag.get<int>(i));
+  }
+  return labels;
+}
+
+}  // namespace
+
+TEST(routing_node_label_store, push_erase_grow) {
+  std::vector<int> values(100);
+  node_label_store store;
+  store.resize(10);
+
+  for (auto& v : values) {
+    store.push_back(3, &v);
+  }
+  store.push_back(7, &values[0]);
+  store.push_back(3, &values[0]);
+
+  auto labels = labels_of(store, 3);
+  ASSERT_EQ(101U, labels.size());
+  for (auto i = 0U; i != values.size(); ++i) {
+    EXPECT_EQ(&values[i], labels[i]);
+  }
+  EXPECT_EQ(&values[0], labels.back());
+  EXPECT_EQ(std::vector<int*>{&values[0]}, labels_of(store, 7));
+  EXPECT_TRUE(store[5].empty());
+  EXPECT_EQ(2U, store.nodes_touched());
+
+  store[3].erase(0);
+  store[3].erase(50);
+  labels = labels_of(store, 3);
+  ASSERT_EQ(99U, labels.size());
+  EXPECT_EQ(&values[1], labels[0]);
+  EXPECT_EQ(&values[50], labels[49]);
+  EXPECT_EQ(&values[52], labels[50]);
+}
+
+TEST(routing_node_label_store, clear_resets_touched_nodes) {
+  std::vector<int> values(20);
+  node_label_store store;
+  store.resize(4);
+
+  for (auto round = 0U; round != 3U; ++round) {
+    for (auto& v : values) {
+      store.push_back(round, &v);
+    }
+    store.push_back(3, &values[round]);
+    EXPECT_EQ(2U, store.nodes_touched());
+    EXPECT_EQ(values.size(), store[round].size());
+    EXPECT_EQ(std::vector<int*>{&values[round]}, labels_of(store, 3));
+
+    store.clear();
+    EXPECT_EQ(0U, store.nodes_touched());
+    for (auto node = 0U; node != 4U; ++node) {
+      EXPECT_TRUE(store[node].empty());
+    }
+  }
+
+  store.resize(8);
+  store.push_back(7, &values[0]);
+  EXPECT_EQ(std::vector<int*>{&values[0]}, labels_of(store, 7));
+}
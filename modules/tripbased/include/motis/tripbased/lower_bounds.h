@@ -24,4 +24,10 @@ struct lower_bounds {
 lower_bounds calc_lower_bounds(schedule const& sched,
                                trip_based_query const& query);
 
+// Travel time lower bounds of all stations (indexed by station id) to the
+// given destinations, without additional edges.
+std::vector<uint32_t> calc_travel_time_lower_bounds(
+    schedule const& sched, search_dir dir,
+    std::vector<station_id> const& destinations);
+
 }  // namespace motis::tripbased
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/tripbased/query.h"
+
+namespace motis::tripbased {
+
+// Travel time lower bounds to the destinations of a query, shared between
+// queries: the least recently used bounds are evicted once the cache is
+// full. Bounds to the configured hubs are computed up front and never
+// evicted (after an invalidation they are recomputed on their next use).
+struct lower_bounds_cache {
+  // per station id, UNREACHABLE if the destinations can not be reached
+  using bounds_ptr = std::shared_ptr<std::vector<uint32_t> const>;
+
+  explicit lower_bounds_cache(std::size_t max_size) : max_size_{max_size} {}
+
+  // Queries with additional (intermodal) edges are not cached.
+  bounds_ptr get(schedule const&, trip_based_query const&,
+                 bool& cache_hit);
+
+  // Hub station ids (eva numbers). Bounds are precomputed for both search
+  // directions, to the hub alone and to the hub with its meta stations.
+  void set_hubs(schedule const&, std::vector<std::string> const& hub_ids);
+
+  // The lower bound graphs of the schedule changed. Nothing is recomputed
+  // here: rt updates must not wait for the hub bounds.
+  void invalidate();
+
+private:
+  using key = std::pair<search_dir, std::vector<station_id>>;
+
+  static bounds_ptr compute(schedule const&, key const&);
+
+  std::mutex mutex_;
+  std::size_t max_size_;
+  std::list<std::pair<key, bounds_ptr>> lru_;  // most recently used first
+  std::map<key, decltype(lru_)::iterator> entries_;
+  std::map<key, bounds_ptr> hubs_;  // nullptr: invalidated
+  std::uint64_t generation_{0U};  // bounds of older generations are dropped
+};
+
+}  // namespace motis::tripbased
@@ -16,6 +16,7 @@
 #include "motis/tripbased/limits.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_search_common.h"
+#include "motis/tripbased/tb_search_state.h"
 #include "motis/tripbased/tb_statistics.h"
 
 namespace motis::tripbased {
@@ -26,7 +27,8 @@ struct tb_ontrip_search {
                                       ? std::numeric_limits<time>::max()
                                       : std::numeric_limits<time>::min();
 
-  tb_ontrip_search(tb_data const& data, schedule const& sched, time start_time,
+  tb_ontrip_search(tb_data const& data, schedule const& sched,
+                   tb_ontrip_state& state, time start_time,
                    bool count_initial_transfer_time,
                    bool count_final_transfer_time, destination_mode dest_mode)
       : data_(data),
@@ -35,11 +37,13 @@ struct tb_ontrip_search {
         count_initial_transfer_time_(count_initial_transfer_time),
         count_final_transfer_time_(count_final_transfer_time),
         destination_mode_(dest_mode),
-        destination_arrivals_(data.line_count_),
-        first_reachable_stop_(data.trip_idx_end_,
-                              Dir == search_dir::FWD
-                                  ? std::numeric_limits<stop_idx_t>::max()
-                                  : std::numeric_limits<stop_idx_t>::min()) {}
+        destination_arrivals_(state.destination_arrivals_),
+        queues_(state.queues_),
+        first_reachable_stop_(state.first_reachable_stop_) {
+    state.reset(data, Dir == search_dir::FWD
+                          ? std::numeric_limits<stop_idx_t>::max()
+                          : std::numeric_limits<stop_idx_t>::min());
+  }
 
   void add_start(station_id stop_id, time initial_duration,
                  bool allow_footpaths = true) {
@@ -225,7 +229,7 @@ private:
       ++stats_.trip_segments_scanned_;
       auto& entry = queue[current_trip_segment];
       auto const line = data_.trip_to_line_[entry.trip_];
-      auto const& destination_arrivals = destination_arrivals_[line];
+      auto const& destination_arrivals = destination_arrivals_.get(line);
       if (!destination_arrivals.empty()) {
         ++stats_.lines_reaching_destination_;
         stats_.destination_arrivals_scanned_ += destination_arrivals.size();
@@ -269,7 +273,7 @@ private:
       ++stats_.trip_segments_scanned_;
       auto& entry = queue[current_trip_segment];
       auto const line = data_.trip_to_line_[entry.trip_];
-      auto const& destination_arrivals = destination_arrivals_[line];
+      auto const& destination_arrivals = destination_arrivals_.get(line);
       if (!destination_arrivals.empty()) {
         ++stats_.lines_reaching_destination_;
         stats_.destination_arrivals_scanned_ += destination_arrivals.size();
@@ -311,7 +315,7 @@ private:
                       std::size_t previous_trip_segment) {
     assert(transfers < queues_.size());
     if (Dir == search_dir::FWD) {
-      auto const old_first_reachable = first_reachable_stop_[trip];
+      auto const old_first_reachable = first_reachable_stop_.get(trip);
       if (stop_index >= old_first_reachable) {
         return;
       }
@@ -322,11 +326,11 @@ private:
       auto const line = data_.trip_to_line_[trip];
       for (trip_id t = trip;
            t < data_.trip_idx_end_ && data_.trip_to_line_[t] == line; ++t) {
-        first_reachable_stop_[t] =
-            std::min(first_reachable_stop_[t], stop_index);
+        auto& first_reachable = first_reachable_stop_[t];
+        first_reachable = std::min(first_reachable, stop_index);
       }
     } else {
-      auto const old_last_reachable = first_reachable_stop_[trip];
+      auto const old_last_reachable = first_reachable_stop_.get(trip);
       if (stop_index <= old_last_reachable) {
         return;
       }
@@ -335,8 +339,8 @@ private:
                          previous_trip_segment);
       auto const line = data_.trip_to_line_[trip];
       for (trip_id t = trip; data_.trip_to_line_[t] == line; --t) {
-        first_reachable_stop_[t] =
-            std::max(first_reachable_stop_[t], stop_index);
+        auto& last_reachable = first_reachable_stop_[t];
+        last_reachable = std::max(last_reachable, stop_index);
         if (t == 0) {
           break;
         }
@@ -439,12 +443,12 @@ private:
   std::vector<station_id> start_stations_;
   std::vector<station_id> destination_stations_;
   std::map<station_id, time> start_times_;
-  std::vector<std::vector<destination_arrival>> destination_arrivals_;
+  epoch_vector<std::vector<destination_arrival>>& destination_arrivals_;
   std::vector<std::vector<tb_journey>> journeys_;
   std::vector<time> earliest_arrival_;
   time total_earliest_arrival_{INVALID};
-  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
-  std::vector<stop_idx_t> first_reachable_stop_;
+  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1>& queues_;
+  epoch_vector<stop_idx_t>& first_reachable_stop_;
   tb_statistics stats_{};
 };
 
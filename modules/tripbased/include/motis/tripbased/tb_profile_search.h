@@ -18,6 +18,7 @@
 #include "motis/tripbased/data.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_search_common.h"
+#include "motis/tripbased/tb_search_state.h"
 #include "motis/tripbased/tb_statistics.h"
 
 #include "motis/tripbased/limits.h"
@@ -48,7 +49,8 @@ struct tb_profile_search {
                                       : std::numeric_limits<time>::min();
 
   tb_profile_search(tb_data const& data, schedule const& sched,
-                    time interval_begin, time interval_end,
+                    tb_profile_state& state, time interval_begin,
+                    time interval_end,
                     bool count_initial_transfer_time,
                     bool count_final_transfer_time, destination_mode dest_mode)
       : data_(data),
@@ -58,15 +60,16 @@ struct tb_profile_search {
         count_initial_transfer_time_(count_initial_transfer_time),
         count_final_transfer_time_(count_final_transfer_time),
         destination_mode_(dest_mode),
-        destination_arrivals_(data.line_count_),
+        destination_arrivals_(state.destination_arrivals_),
         total_earliest_arrival_(
             array_maker<time, MAX_TRANSFERS + 1>::make_array(INVALID)),
-        first_reachable_stop_(
-            data.trip_idx_end_,
-            array_maker<stop_idx_t, MAX_TRANSFERS + 1>::make_array(
-                Dir == search_dir::FWD
-                    ? std::numeric_limits<stop_idx_t>::max()
-                    : std::numeric_limits<stop_idx_t>::min())) {}
+        queues_(state.queues_),
+        first_reachable_stop_(state.first_reachable_stop_) {
+    state.reset(data, array_maker<stop_idx_t, MAX_TRANSFERS + 1>::make_array(
+                          Dir == search_dir::FWD
+                              ? std::numeric_limits<stop_idx_t>::max()
+                              : std::numeric_limits<stop_idx_t>::min()));
+  }
 
   void add_start(station_id stop_id, time initial_duration,
                  bool allow_footpaths = true) {
@@ -269,7 +272,7 @@ private:
       ++stats_.trip_segments_scanned_;
       auto& entry = queue[current_trip_segment];
       auto const line = data_.trip_to_line_[entry.trip_];
-      auto const& destination_arrivals = destination_arrivals_[line];
+      auto const& destination_arrivals = destination_arrivals_.get(line);
       if (!destination_arrivals.empty()) {
         ++stats_.lines_reaching_destination_;
         stats_.destination_arrivals_scanned_ += destination_arrivals.size();
@@ -316,7 +319,7 @@ private:
       ++stats_.trip_segments_scanned_;
       auto& entry = queue[current_trip_segment];
       auto const line = data_.trip_to_line_[entry.trip_];
-      auto const& destination_arrivals = destination_arrivals_[line];
+      auto const& destination_arrivals = destination_arrivals_.get(line);
       if (!destination_arrivals.empty()) {
         ++stats_.lines_reaching_destination_;
         stats_.destination_arrivals_scanned_ += destination_arrivals.size();
@@ -362,7 +365,7 @@ private:
     assert(transfers < queues_.size());
     if (Dir == search_dir::FWD) {
       auto const old_first_reachable =
-          first_reachable_stop_[trip][transfers];  // NOLINT
+          first_reachable_stop_.get(trip)[transfers];  // NOLINT
       if (stop_index >= old_first_reachable) {
         return;
       }
@@ -373,13 +376,14 @@ private:
       auto const line = data_.trip_to_line_[trip];
       for (trip_id t = trip;
            t < data_.trip_idx_end_ && data_.trip_to_line_[t] == line; ++t) {
+        auto& first_reachable = first_reachable_stop_[t];
         for (auto trfs = transfers; trfs <= MAX_TRANSFERS; ++trfs) {
-          first_reachable_stop_[t][trfs] =
-              std::min(first_reachable_stop_[t][trfs], stop_index);
+          first_reachable[trfs] = std::min(first_reachable[trfs], stop_index);
         }
       }
     } else {
-      auto const old_last_reachable = first_reachable_stop_[trip][transfers];
+      auto const old_last_reachable =
+          first_reachable_stop_.get(trip)[transfers];  // NOLINT
       if (stop_index <= old_last_reachable) {
         return;
       }
@@ -388,9 +392,9 @@ private:
                          previous_trip_segment);
       auto const line = data_.trip_to_line_[trip];
       for (trip_id t = trip; data_.trip_to_line_[t] == line; --t) {
+        auto& last_reachable = first_reachable_stop_[t];
         for (auto trfs = transfers; trfs <= MAX_TRANSFERS; ++trfs) {
-          first_reachable_stop_[t][trfs] =
-              std::max(first_reachable_stop_[t][trfs], stop_index);
+          last_reachable[trfs] = std::max(last_reachable[trfs], stop_index);
         }
         if (t == 0) {
           break;
@@ -553,14 +557,15 @@ private:
   std::vector<std::tuple<station_id, time, bool>> start_stations_;
   std::vector<station_id> destination_stations_;
   std::map<station_id, time> start_times_;
-  std::vector<std::vector<destination_arrival>> destination_arrivals_;
+  epoch_vector<std::vector<destination_arrival>>& destination_arrivals_;
   std::vector<std::vector<tb_journey>> journeys_;
   std::map<station_id, std::vector<tb_journey>> results_;
   unsigned result_count_{0};
   std::vector<std::array<time, MAX_TRANSFERS + 1>> earliest_arrival_;
   std::array<time, MAX_TRANSFERS + 1> total_earliest_arrival_;
-  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
-  std::vector<std::array<stop_idx_t, MAX_TRANSFERS + 1>> first_reachable_stop_;
+  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1>& queues_;
+  epoch_vector<std::array<stop_idx_t, MAX_TRANSFERS + 1>>&
+      first_reachable_stop_;
   tb_statistics stats_{};
 };
 
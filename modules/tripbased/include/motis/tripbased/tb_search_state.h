@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "motis/tripbased/data.h"
+#include "motis/tripbased/limits.h"
+#include "motis/tripbased/tb_search_common.h"
+
+namespace motis::tripbased {
+
+// Vector with lazy reset: every entry remembers the epoch in which it was
+// written last. Entries from older epochs read as the initial value, so
+// starting a new epoch does not touch the entries.
+template <typename T>
+struct epoch_vector {
+  void new_epoch(std::size_t const size, T const& init) {
+    if (entries_.size() < size) {
+      entries_.resize(size);
+    }
+    init_ = init;
+    if (++epoch_ == 0U) {
+      for (auto& e : entries_) {
+        e.epoch_ = 0U;
+      }
+      epoch_ = 1U;
+    }
+  }
+
+  T const& get(std::size_t const i) const {
+    auto const& e = entries_[i];
+    return e.epoch_ == epoch_ ? e.value_ : init_;
+  }
+
+  T& operator[](std::size_t const i) {
+    auto& e = entries_[i];
+    if (e.epoch_ != epoch_) {
+      e.epoch_ = epoch_;
+      e.value_ = init_;
+    }
+    return e.value_;
+  }
+
+private:
+  struct entry {
+    std::uint32_t epoch_{0U};
+    T value_{};
+  };
+
+  std::vector<entry> entries_;
+  T init_{};
+  std::uint32_t epoch_{0U};
+};
+
+// Buffers of the trip-based searches that are sized by the number of trips
+// or lines. They are kept per thread and reused by all searches of that
+// thread (see tripbased.cc), reset() costs O(1) instead of O(trips).
+template <typename FirstReachable>
+struct tb_search_state {
+  void reset(tb_data const& data, FirstReachable const& first_reachable_init) {
+    first_reachable_stop_.new_epoch(data.trip_idx_end_, first_reachable_init);
+    destination_arrivals_.new_epoch(data.line_count_, {});
+    for (auto& q : queues_) {
+      q.clear();
+    }
+  }
+
+  epoch_vector<FirstReachable> first_reachable_stop_;
+  epoch_vector<std::vector<destination_arrival>> destination_arrivals_;
+  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
+};
+
+using tb_ontrip_state = tb_search_state<stop_idx_t>;
+using tb_profile_state =
+    tb_search_state<std::array<stop_idx_t, MAX_TRANSFERS + 1>>;
+
+}  // namespace motis::tripbased
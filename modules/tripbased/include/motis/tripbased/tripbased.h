@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "motis/module/module.h"
 
 namespace motis::tripbased {
@@ -26,6 +29,8 @@ struct tripbased : public motis::module::module {
 
 private:
   bool use_data_file_{true};
+  std::size_t lower_bounds_cache_size_{64U};
+  std::vector<std::string> lower_bounds_hubs_;
 
   bool import_successful_{false};
 
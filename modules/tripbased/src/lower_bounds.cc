@@ -33,4 +33,19 @@ lower_bounds calc_lower_bounds(schedule const& sched,
   return lbs;
 }
 
+std::vector<uint32_t> calc_travel_time_lower_bounds(
+    schedule const& sched, search_dir const dir,
+    std::vector<station_id> const& destinations) {
+  mcd::hash_map<unsigned, std::vector<simple_edge>> const no_edges;
+  lower_bounds lbs(dir == search_dir::FWD ? sched.travel_time_lower_bounds_fwd_
+                                          : sched.travel_time_lower_bounds_bwd_,
+                   utl::to_vec(destinations,
+                               [](station_id const station) {
+                                 return static_cast<int>(station);
+                               }),
+                   no_edges);
+  lbs.travel_time_.run();
+  return {begin(lbs.travel_time_.dists_), end(lbs.travel_time_.dists_)};
+}
+
 }  // namespace motis::tripbased
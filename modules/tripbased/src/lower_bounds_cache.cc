@@ -0,0 +1,121 @@
+#include "motis/tripbased/lower_bounds_cache.h"
+
+#include "utl/erase_duplicates.h"
+#include "utl/to_vec.h"
+
+#include "motis/core/common/logging.h"
+#include "motis/core/access/station_access.h"
+
+#include "motis/tripbased/lower_bounds.h"
+
+using namespace motis::logging;
+
+namespace motis::tripbased {
+
+lower_bounds_cache::bounds_ptr lower_bounds_cache::compute(
+    schedule const& sched, key const& k) {
+  return std::make_shared<std::vector<uint32_t> const>(
+      calc_travel_time_lower_bounds(sched, k.first, k.second));
+}
+
+lower_bounds_cache::bounds_ptr lower_bounds_cache::get(
+    schedule const& sched, trip_based_query const& q, bool& cache_hit) {
+  cache_hit = false;
+  if (!q.start_edges_.empty() || !q.destination_edges_.empty()) {
+    auto const lbs = calc_lower_bounds(sched, q);
+    return std::make_shared<std::vector<uint32_t> const>(
+        begin(lbs.travel_time_.dists_), end(lbs.travel_time_.dists_));
+  }
+
+  auto k = key{q.dir_, q.meta_destinations_};
+  utl::erase_duplicates(k.second);
+
+  auto generation = std::uint64_t{0U};
+  auto is_hub = false;
+  {
+    std::lock_guard const lock{mutex_};
+    generation = generation_;
+    if (auto const it = hubs_.find(k); it != end(hubs_)) {
+      if (it->second != nullptr) {
+        cache_hit = true;
+        return it->second;
+      }
+      is_hub = true;
+    } else if (auto const it = entries_.find(k); it != end(entries_)) {
+      lru_.splice(begin(lru_), lru_, it->second);
+      cache_hit = true;
+      return it->second->second;
+    }
+  }
+
+  // computed without holding the lock, concurrent misses compute twice
+  auto bounds = compute(sched, k);
+  if (!is_hub && max_size_ == 0U) {
+    return bounds;
+  }
+
+  std::lock_guard const lock{mutex_};
+  if (generation != generation_) {
+    return bounds;  // invalidated while computing
+  }
+  if (is_hub) {
+    auto& hub = hubs_[k];
+    if (hub == nullptr) {
+      hub = bounds;
+    }
+    return hub;
+  }
+  if (entries_.find(k) == end(entries_)) {
+    lru_.emplace_front(k, bounds);
+    entries_.emplace(std::move(k), begin(lru_));
+    if (lru_.size() > max_size_) {
+      entries_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+  return bounds;
+}
+
+void lower_bounds_cache::set_hubs(schedule const& sched,
+                                  std::vector<std::string> const& hub_ids) {
+  auto hubs = std::map<key, bounds_ptr>{};
+  for (auto const& id : hub_ids) {
+    auto const* st = find_station(sched, id);
+    if (st == nullptr) {
+      LOG(warn) << "tripbased: lower bounds hub not found: " << id;
+      continue;
+    }
+
+    auto metas = utl::to_vec(st->equivalent_, [](station const* equivalent) {
+      return static_cast<station_id>(equivalent->index_);
+    });
+    metas.push_back(st->index_);
+    utl::erase_duplicates(metas);
+
+    for (auto const dir : {search_dir::FWD, search_dir::BWD}) {
+      for (auto const& destinations :
+           {std::vector<station_id>{st->index_}, metas}) {
+        auto k = key{dir, destinations};
+        if (hubs.find(k) == end(hubs)) {
+          auto bounds = compute(sched, k);
+          hubs.emplace(std::move(k), std::move(bounds));
+        }
+      }
+    }
+  }
+
+  std::lock_guard const lock{mutex_};
+  hubs_ = std::move(hubs);
+}
+
+void lower_bounds_cache::invalidate() {
+  std::lock_guard const lock{mutex_};
+  ++generation_;
+  lru_.clear();
+  entries_.clear();
+  for (auto& [k, bounds] : hubs_) {
+    bounds = nullptr;
+  }
+}
+
+}  // namespace motis::tripbased
@@ -10,6 +10,8 @@
 #include <utility>
 #include <vector>
 
+#include "boost/thread/tss.hpp"
+
 #include "utl/progress_tracker.h"
 #include "utl/raii.h"
 #include "utl/to_vec.h"
@@ -18,11 +20,13 @@
 #include "motis/tripbased/debug.h"
 #include "motis/tripbased/error.h"
 #include "motis/tripbased/lower_bounds.h"
+#include "motis/tripbased/lower_bounds_cache.h"
 #include "motis/tripbased/preprocessing.h"
 #include "motis/tripbased/query.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_ontrip_search.h"
 #include "motis/tripbased/tb_profile_search.h"
+#include "motis/tripbased/tb_search_state.h"
 #include "motis/tripbased/tb_to_journey.h"
 #include "motis/tripbased/tripbased.h"
 
@@ -41,10 +45,25 @@
 using namespace motis::module;
 using namespace motis::logging;
 using namespace motis::routing;
+using namespace motis::rt;
 using namespace flatbuffers;
 
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+boost::thread_specific_ptr<motis::tripbased::tb_ontrip_state> ontrip_state;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+boost::thread_specific_ptr<motis::tripbased::tb_profile_state> profile_state;
+
 namespace motis::tripbased {
 
+template <typename State>
+State& get_thread_state(boost::thread_specific_ptr<State>& state) {
+  if (state.get() == nullptr) {
+    state.reset(new State{});
+  }
+  return *state;
+}
+
 inline bool is_virtual_start_station(station_id id) { return id == 0; }
 
 inline bool is_virtual_end_station(station_id id) { return id == 1; }
@@ -241,8 +260,11 @@ void add_result(std::vector<tb_journey>& results, tb_journey const& tbj,
 }
 
 struct tripbased::impl {
-  explicit impl(schedule const& sched, std::unique_ptr<tb_data> data)
-      : tb_data_{std::move(data)}, sched_{sched} {}
+  impl(schedule const& sched, std::unique_ptr<tb_data> data,
+       std::size_t const lower_bounds_cache_size)
+      : tb_data_{std::move(data)},
+        sched_{sched},
+        lower_bounds_cache_{lower_bounds_cache_size} {}
 
   msg_ptr route(msg_ptr const& msg) {
     auto const req = motis_content(RoutingRequest, msg);
@@ -298,8 +320,8 @@ struct tripbased::impl {
     trip_based_result res{};
     MOTIS_START_TIMING(search_timing);
     tb_ontrip_search<Dir> tbs(
-        *tb_data_, sched, q.start_time_, q.intermodal_start_,
-        q.intermodal_destination_,
+        *tb_data_, sched, get_thread_state(ontrip_state), q.start_time_,
+        q.intermodal_start_, q.intermodal_destination_,
         q.use_dest_metas_ ? destination_mode::ANY : destination_mode::ALL);
 
     add_starts_and_destinations(q, tbs);
@@ -329,6 +351,7 @@ struct tripbased::impl {
     auto const schedule_end =
         static_cast<time>((sched.schedule_end_ - sched.schedule_begin_) / 60);
     uint64_t lower_bounds_duration = 0;
+    auto lower_bounds_cache_hit = false;
 
     auto const map_to_interval = [&schedule_begin, &schedule_end](time t) {
       return std::min(schedule_end, std::max(schedule_begin, t));
@@ -380,7 +403,9 @@ struct tripbased::impl {
           (!q.extend_interval_earlier_ || interval_begin == schedule_begin) &&
           (!q.extend_interval_later_ || interval_end == schedule_end);
 
-      tb_profile_search<Dir> tbs(*tb_data_, sched, interval_begin, interval_end,
+      tb_profile_search<Dir> tbs(*tb_data_, sched,
+                                 get_thread_state(profile_state),
+                                 interval_begin, interval_end,
                                  q.intermodal_start_, q.intermodal_destination_,
                                  dest_mode);
       add_starts_and_destinations(q, tbs);
@@ -397,7 +422,8 @@ struct tripbased::impl {
       }
 
       if (interval_extensions == 0 && res.journeys_.empty()) {
-        if (!is_reachable(sched, q, lower_bounds_duration)) {
+        if (!is_reachable(sched, q, lower_bounds_duration,
+                          lower_bounds_cache_hit)) {
           break;
         }
       }
@@ -426,6 +452,8 @@ struct tripbased::impl {
 
     for (auto& tbs : tb_stats) {
       tbs.lower_bounds_duration_ = lower_bounds_duration;
+      tbs.lower_bounds_cache_hit_ =
+          static_cast<uint64_t>(lower_bounds_cache_hit);
     }
 
     res.stats_.emplace_back(to_stats_category("tripbased", tb_stats.back()));
@@ -444,19 +472,19 @@ struct tripbased::impl {
     return res;
   }
 
-  static bool is_reachable(schedule const& sched, trip_based_query const& q,
-                           uint64_t& lower_bounds_duration) {
+  bool is_reachable(schedule const& sched, trip_based_query const& q,
+                    uint64_t& lower_bounds_duration, bool& cache_hit) {
+    using dijkstra_t =
+        constant_graph_dijkstra<MAX_TRAVEL_TIME, map_station_graph_node>;
     MOTIS_START_TIMING(lower_bounds_timing);
-    auto const lbs = calc_lower_bounds(sched, q);
+    auto const lbs = lower_bounds_cache_.get(sched, q, cache_hit);
     MOTIS_STOP_TIMING(lower_bounds_timing);
     lower_bounds_duration =
         static_cast<uint64_t>(MOTIS_TIMING_MS(lower_bounds_timing));
-    return std::any_of(
-        begin(q.meta_starts_), end(q.meta_starts_),
-        [&](station_id const station) {
-          return lbs.travel_time_.is_reachable(
-              lbs.travel_time_[sched.station_nodes_[station].get()]);
-        });
+    return std::any_of(begin(q.meta_starts_), end(q.meta_starts_),
+                       [&](station_id const station) {
+                         return (*lbs)[station] != dijkstra_t::UNREACHABLE;
+                       });
   }
 
   template <typename TBS>
@@ -628,6 +656,7 @@ struct tripbased::impl {
 
   std::unique_ptr<tb_data> tb_data_;
   schedule const& sched_;
+  lower_bounds_cache lower_bounds_cache_;
 };
 
 struct import_state {
@@ -638,6 +667,10 @@ struct import_state {
 tripbased::tripbased() : module("Trip-Based Routing Options", "tripbased") {
   param(use_data_file_, "use_data_file",
         "create a data_file to speed up subsequent loading");
+  param(lower_bounds_cache_size_, "lower_bounds_cache_size",
+        "number of destinations to cache lower bounds for, 0=disabled");
+  param(lower_bounds_hubs_, "lower_bounds_hubs",
+        "station ids to precompute lower bounds for at import");
 }
 
 tripbased::~tripbased() = default;
@@ -674,7 +707,13 @@ void tripbased::import(motis::module::import_dispatcher& reg) {
         }
 
         if (data) {
-          impl_ = std::make_unique<impl>(sched, std::move(data));
+          impl_ = std::make_unique<impl>(sched, std::move(data),
+                                         lower_bounds_cache_size_);
+          if (!lower_bounds_hubs_.empty()) {
+            logging::scoped_timer const timer{
+                "tripbased: precomputing hub lower bounds"};
+            impl_->lower_bounds_cache_.set_hubs(sched, lower_bounds_hubs_);
+          }
           import_successful_ = true;
         }
       })
@@ -696,12 +735,23 @@ void tripbased::init(motis::module::registry& reg) {
         "/tripbased/update_timetable",
         [&](msg_ptr const&) -> msg_ptr {
           impl_->tb_data_ = build_data(get_sched());
+          impl_->lower_bounds_cache_.invalidate();
           return {};
         },
         ctx::accesses_t{ctx::access_request{
             to_res_id(::motis::module::global_res_id::SCHEDULE),
             ctx::access_t::WRITE}});
 
+    reg.subscribe(
+        "/rt/graph_updated",
+        [this](msg_ptr const& msg) -> msg_ptr {
+          if (motis_content(RtGraphUpdated, msg)->schedule() == 0U) {
+            impl_->lower_bounds_cache_.invalidate();
+          }
+          return nullptr;
+        },
+        {kScheduleReadAccess});
+
   } catch (std::exception const& e) {
     LOG(logging::warn) << "tripbased module not initialized (" << e.what()
                        << ")";
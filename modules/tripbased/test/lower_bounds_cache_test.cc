@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "motis/loader/loader.h"
+#include "motis/test/schedule/simple_realtime.h"
+
+#include "motis/tripbased/lower_bounds.h"
+#include "motis/tripbased/lower_bounds_cache.h"
+
+using namespace motis;
+using namespace motis::tripbased;
+using motis::test::schedule::simple_realtime::dataset_opt_short;
+
+namespace {
+
+trip_based_query make_query(std::vector<station_id> destinations,
+                             search_dir const dir = search_dir::FWD) {
+  auto q = trip_based_query{};
+  q.dir_ = dir;
+  q.meta_destinations_ = std::move(destinations);
+  return q;
+}
+
+struct lookup_result {
+  lower_bounds_cache::bounds_ptr bounds_;
+  bool hit_{false};
+};
+
+lookup_result get(lower_bounds_cache& cache, schedule const& sched,
+                  trip_based_query const& q) {
+  auto res = lookup_result{};
+  res.bounds_ = cache.get(sched, q, res.hit_);
+  return res;
+}
+
+}  // namespace
+
+struct tripbased_lower_bounds_cache_test : public ::testing::Test {
+  void SetUp() override {
+    sched_ = loader::load_schedule(dataset_opt_short);
+    ASSERT_GE(sched_->stations_.size(), 3U);
+  }
+
+  station_id station(std::size_t const i) const {
+    return static_cast<station_id>(sched_->stations_[i]->index_);
+  }
+
+  schedule_ptr sched_;
+};
+
+TEST_F(tripbased_lower_bounds_cache_test, hit) {
+  auto cache = lower_bounds_cache{10U};
+  auto const& sched = *sched_;
+
+  auto const miss = get(cache, sched, make_query({station(0), station(1)}));
+  EXPECT_FALSE(miss.hit_);
+  ASSERT_NE(nullptr, miss.bounds_);
+  EXPECT_EQ(calc_travel_time_lower_bounds(sched, search_dir::FWD,
+                                          {station(0), station(1)}),
+            *miss.bounds_);
+
+  // destination order and duplicates do not matter
+  auto const hit =
+      get(cache, sched, make_query({station(1), station(0), station(1)}));
+  EXPECT_TRUE(hit.hit_);
+  EXPECT_EQ(miss.bounds_, hit.bounds_);
+
+  // the search direction is part of the key
+  auto const bwd = get(cache, sched,
+                       make_query({station(0), station(1)}, search_dir::BWD));
+  EXPECT_FALSE(bwd.hit_);
+  EXPECT_EQ(calc_travel_time_lower_bounds(sched, search_dir::BWD,
+                                          {station(0), station(1)}),
+            *bwd.bounds_);
+}
+
+TEST_F(tripbased_lower_bounds_cache_test, evicts_least_recently_used) {
+  auto cache = lower_bounds_cache{2U};
+  auto const& sched = *sched_;
+  auto const a = make_query({station(0)});
+  auto const b = make_query({station(1)});
+  auto const c = make_query({station(2)});
+
+  EXPECT_FALSE(get(cache, sched, a).hit_);
+  EXPECT_FALSE(get(cache, sched, b).hit_);
+  EXPECT_TRUE(get(cache, sched, a).hit_);  // b is now least recently used
+
+  EXPECT_FALSE(get(cache, sched, c).hit_);  // evicts b
+  EXPECT_TRUE(get(cache, sched, a).hit_);
+  EXPECT_TRUE(get(cache, sched, c).hit_);
+  EXPECT_FALSE(get(cache, sched, b).hit_);  // evicts a
+  EXPECT_FALSE(get(cache, sched, a).hit_);
+}
+
+TEST_F(tripbased_lower_bounds_cache_test, disabled) {
+  auto cache = lower_bounds_cache{0U};
+  auto const& sched = *sched_;
+  auto const q = make_query({station(0)});
+
+  auto const first = get(cache, sched, q);
+  auto const second = get(cache, sched, q);
+  EXPECT_FALSE(first.hit_);
+  EXPECT_FALSE(second.hit_);
+  EXPECT_NE(first.bounds_, second.bounds_);
+  EXPECT_EQ(*first.bounds_, *second.bounds_);
+}
+
+TEST_F(tripbased_lower_bounds_cache_test, hubs_survive_invalidate) {
+  auto cache = lower_bounds_cache{0U};
+  auto const& sched = *sched_;
+  auto const hub = sched.stations_[1]->eva_nr_.str();
+  cache.set_hubs(sched, {hub, "not a station"});
+
+  auto const q = make_query({station(1)});
+  auto const before = get(cache, sched, q);
+  EXPECT_TRUE(before.hit_);
+  EXPECT_TRUE(
+      get(cache, sched, make_query({station(1)}, search_dir::BWD)).hit_);
+  EXPECT_FALSE(get(cache, sched, make_query({station(0)})).hit_);
+
+  cache.invalidate();
+
+  // recomputed on the first lookup, kept afterwards
+  auto const after = get(cache, sched, q);
+  EXPECT_FALSE(after.hit_);
+  EXPECT_NE(before.bounds_, after.bounds_);
+  EXPECT_EQ(calc_travel_time_lower_bounds(sched, search_dir::FWD,
+                                          {station(1)}),
+            *after.bounds_);
+
+  auto const again = get(cache, sched, q);
+  EXPECT_TRUE(again.hit_);
+  EXPECT_EQ(after.bounds_, again.bounds_);
+}
+
+TEST_F(tripbased_lower_bounds_cache_test, invalidate_drops_entries) {
+  auto cache = lower_bounds_cache{10U};
+  auto const& sched = *sched_;
+  auto const q = make_query({station(0)});
+
+  EXPECT_FALSE(get(cache, sched, q).hit_);
+  EXPECT_TRUE(get(cache, sched, q).hit_);
+  cache.invalidate();
+  EXPECT_FALSE(get(cache, sched, q).hit_);
+}
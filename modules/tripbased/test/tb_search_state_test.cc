@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "motis/tripbased/tb_search_state.h"
+
+using namespace motis::tripbased;
+
+TEST(tripbased_search_state, epoch_vector_lazy_reset) {
+  epoch_vector<int> v;
+  v.new_epoch(4, -1);
+  for (auto i = 0U; i != 4U; ++i) {
+    EXPECT_EQ(-1, v.get(i));
+  }
+
+  v[1] = 7;
+  v[3] += 2;
+  EXPECT_EQ(7, v.get(1));
+  EXPECT_EQ(1, v.get(3));
+  EXPECT_EQ(-1, v.get(2));
+
+  v.new_epoch(6, 0);
+  for (auto i = 0U; i != 6U; ++i) {
+    EXPECT_EQ(0, v.get(i));
+  }
+  v[5] = 3;
+  EXPECT_EQ(3, v.get(5));
+}
+
+TEST(tripbased_search_state, epoch_vector_keeps_capacity) {
+  epoch_vector<std::vector<int>> v;
+  v.new_epoch(2, {});
+  v[0].resize(100);
+  auto const data = v.get(0).data();
+
+  v.new_epoch(2, {});
+  EXPECT_TRUE(v.get(0).empty());
+  v[0].push_back(1);
+  EXPECT_EQ(1U, v.get(0).size());
+  EXPECT_EQ(data, v.get(0).data());
+}